@@ -0,0 +1,55 @@
+// The settings main.ino provides on the device, for host builds. Serial
+// output can be switched per executable:
+//   DEEJ_SIM_BINARY      SERIAL_PROTOCOL_BINARY instead of ASCII
+//   DEEJ_SIM_EVERY_LOOP  SERIAL_OUTPUT_EVERY_LOOP instead of ON_CHANGE
+
+#include "DeejControl.h"
+#include "DisplayRenderer.h"
+
+const int ENCODER1_CLK = 4;
+const int ENCODER1_DT = 6;
+const int ENCODER1_SW = 5;
+
+const int ENCODER2_CLK = 3;
+const int ENCODER2_DT = 10;
+const int ENCODER2_SW = 8;
+
+const QuadratureConfig encoder1Config = {2, true, true};
+const QuadratureConfig encoder2Config = {2, false, true};
+
+const ButtonConfig button1Config = {30, 300, 1000};
+const ButtonConfig button2Config = {30, 300, 10000};
+
+const unsigned int displayMaxFps = 30;
+
+#ifdef DEEJ_SIM_EVERY_LOOP
+const SerialOutputMode serialOutputMode = SERIAL_OUTPUT_EVERY_LOOP;
+#else
+const SerialOutputMode serialOutputMode = SERIAL_OUTPUT_ON_CHANGE;
+#endif
+const unsigned long keyframeInterval = 1000;
+#ifdef DEEJ_SIM_BINARY
+const SerialProtocol serialProtocol = SERIAL_PROTOCOL_BINARY;
+#else
+const SerialProtocol serialProtocol = SERIAL_PROTOCOL_ASCII;
+#endif
+
+// WifiSetup.cpp is not built on the host; setup mode only stops the control loop
+bool inWifiSetupMode = false;
+int wifiSetupModeEntries = 0;
+
+void startWifiSetupMode() {
+    inWifiSetupMode = true;
+    wifiSetupModeEntries++;
+}
+
+void displayError(const char* line1, const char* line2) {
+    lockDisplay();
+    halDisplay().clearBuffer();
+    halDisplay().setFont(HAL_FONT_NORMAL);
+    halDisplay().drawStr(0, 15, line1);
+    halDisplay().drawStr(0, 35, line2);
+    halDisplay().sendBuffer();
+    invalidateDisplay();
+    unlockDisplay();
+}
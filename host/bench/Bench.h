@@ -0,0 +1,30 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+// Wall-clock timing for the host benchmarks. They are built with the tests
+// but not run by ctest; run them by hand from the build directory.
+
+inline uint64_t benchNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps the compiler from dropping a result the benchmark never reads
+inline void benchKeep(const void* p) {
+    asm volatile("" : : "g"(p) : "memory");
+}
+
+// Runs body iterations times, after a tenth as many to warm up, and returns ns per call
+template <typename Body>
+double benchPerCall(long iterations, Body body) {
+    for (long i = 0; i < iterations / 10; i++) body(i);
+    uint64_t start = benchNanos();
+    for (long i = 0; i < iterations; i++) body(i);
+    return (double)(benchNanos() - start) / iterations;
+}
+
+#endif
@@ -0,0 +1,42 @@
+// Frame encoding: encodeDeejFrame() into its preallocated buffer against the
+// String-built line it replaced (std::string here, which like Arduino String
+// allocates as it grows), at a few slider counts.
+
+#include "Bench.h"
+#include "DeejFrame.h"
+
+#include <string>
+#include <vector>
+
+static std::string stringFrame(const int* values, int count) {
+    std::string line;
+    for (int i = 0; i < count; i++) {
+        line += std::to_string(values[i] * 1023L / 100);
+        if (i < count - 1) line += "|";
+    }
+    line += "\r\n";
+    return line;
+}
+
+int main() {
+    const long iterations = 2000000;
+    printf("%8s %14s %14s %8s\n", "sliders", "string ns", "encoder ns", "speedup");
+
+    for (int count : {3, 8, 16, 64}) {
+        std::vector<int> values(count);
+        std::vector<char> buf(deejFrameBufferSize(count));
+
+        double stringNs = benchPerCall(iterations, [&](long i) {
+            values[i % count] = i % 101;
+            std::string frame = stringFrame(values.data(), count);
+            benchKeep(frame.data());
+        });
+        double encoderNs = benchPerCall(iterations, [&](long i) {
+            values[i % count] = i % 101;
+            encodeDeejFrame(buf.data(), buf.size(), values.data(), count);
+            benchKeep(buf.data());
+        });
+        printf("%8d %14.1f %14.1f %7.1fx\n", count, stringNs, encoderNs, stringNs / encoderNs);
+    }
+    return 0;
+}
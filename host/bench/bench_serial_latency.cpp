@@ -0,0 +1,232 @@
+// Input-to-host latency over a pty. The controller runs on the wall clock
+// (hostUseRealTime()) and writes its serial output to one end of a pty; a
+// reader thread on the other end timestamps every frame as a host would get
+// it. An injector thread turns the volume encoder at fixed step rates.
+//
+// A step counts as delivered by the first frame holding its value or a newer
+// one, so steps a coalesced frame skips over take that frame's time. That
+// makes delivery alone say little at high rates: one frame can carry hundreds
+// of steps. So a rate is only sustained if the injector achieved it, nearly
+// every step had a frame of its own, and p99 stayed under
+// SUSTAINABLE_P99_MICROS. Reported per rate with its latency percentiles,
+// then the highest rate that was sustained. Rates are not required to be
+// sustained in order, so one noisy rate doesn't decide the headline; the
+// per-rate column shows where it dropped out.
+//
+// Each rate runs for RUN_MICROS and at least MIN_SAMPLES steps, so the
+// percentiles have enough samples behind them, after an unmeasured warm-up.
+//
+// The output mode is the build's (SimConfig.cpp): bench_serial_latency is
+// ASCII on change, _every_loop and _binary the other modes.
+
+#include "Bench.h"
+#include "DeejControl.h"
+#include "DeejFrame.h"
+#include "FakeSerial.h"
+#include "HostHal.h"
+#include "SliderProtocol.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <mutex>
+#include <stdlib.h>
+#include <string>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+const uint64_t RUN_MICROS = 1000000;  // Per step rate, at least
+const size_t MIN_SAMPLES = 500;
+const uint64_t WARM_UP_MICROS = 500000;
+const double MIN_ACHIEVED = 0.95;    // Of the requested rate
+const double MIN_OWN_FRAMES = 0.95;  // Of the steps
+const uint64_t SETTLE_MICROS = 200000;  // After the last step, for its frame to arrive
+const uint64_t SUSTAINABLE_P99_MICROS = 10000;
+const int SWEEP_DETENTS = 40;  // 100 down to 20 and back at 2 units per detent
+
+struct Step {
+    uint64_t timeMicros;
+    uint16_t value;  // Slider 0 as the host should see it once this step is out
+};
+
+struct Frame {
+    uint64_t timeMicros;
+    uint16_t value;
+};
+
+std::mutex framesMutex;
+std::vector<Frame> frames;
+
+// Splits what arrives on the pty into frames and records slider 0 from each
+static void readFrames(int fd) {
+    std::vector<uint8_t> pending;
+    uint16_t values[SLIDER_PACKET_MAX_SLIDERS] = {0};
+    SliderPacket packet;
+    uint8_t buf[4096];
+
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) continue;
+        uint64_t now = hostTimeMicros();
+
+        for (ssize_t i = 0; i < n; i++) {
+            uint8_t byte = buf[i];
+            bool end = serialProtocol == SERIAL_PROTOCOL_BINARY ? byte == 0x00 : byte == '\n';
+            if (!end) {
+                pending.push_back(byte);
+                continue;
+            }
+
+            bool ok = false;
+            if (serialProtocol == SERIAL_PROTOCOL_BINARY) {
+                // Log lines share the stream; they fail to decode and are skipped
+                if (decodeSliderPacket(pending.data(), pending.size(), packet)) {
+                    for (int s = 0; s < packet.count; s++) {
+                        if (packet.mask[s / 8] & (1 << (s % 8))) values[s] = packet.values[s];
+                    }
+                    ok = packet.count > 0;
+                }
+            } else if (!pending.empty() && pending[0] >= '0' && pending[0] <= '9') {
+                std::string line(pending.begin(), pending.end());
+                values[0] = atoi(line.c_str());
+                ok = true;
+            }
+            pending.clear();
+
+            if (ok) {
+                std::lock_guard<std::mutex> lock(framesMutex);
+                frames.push_back({now, values[0]});
+            }
+        }
+    }
+}
+
+// One detent of encoder 1; it is reversed, so clockwise lowers the volume.
+// Half-cycle: CLK/DT go 11 -> 10 -> 00 on one detent, 00 -> 01 -> 11 on the next.
+static void turn(bool clockwise) {
+    bool rest = halDigitalRead(ENCODER1_CLK);
+    hostSetPin(clockwise ? ENCODER1_DT : ENCODER1_CLK, !rest);
+    hostSetPin(clockwise ? ENCODER1_CLK : ENCODER1_DT, !rest);
+}
+
+static uint64_t percentile(std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+// Matches frames to steps in order, returning each delivered step's latency.
+// ownFrames counts the steps a frame delivered as its newest.
+static std::vector<uint64_t> latencies(const std::vector<Step>& steps, const std::vector<Frame>& received,
+                                       size_t& ownFrames) {
+    std::vector<uint64_t> result;
+    ownFrames = 0;
+    size_t next = 0;
+    for (const Frame& frame : received) {
+        // The newest step out by then that this frame shows
+        size_t shown = steps.size();
+        for (size_t j = next; j < steps.size() && steps[j].timeMicros <= frame.timeMicros; j++) {
+            if (steps[j].value == frame.value) shown = j;
+        }
+        if (shown == steps.size()) continue;
+        for (size_t j = next; j <= shown; j++) result.push_back(frame.timeMicros - steps[j].timeMicros);
+        next = shown + 1;
+        ownFrames++;
+    }
+    return result;
+}
+
+// Sweeping the volume 100 -> 20 -> 100
+int sweepValue = 100;
+int sweepPosition = 0;  // Detents into the sweep
+
+// Turns at rate steps per second for at least minMicros and minSteps
+static std::vector<Step> injectSteps(int rate, uint64_t minMicros, size_t minSteps) {
+    std::vector<Step> steps;
+    uint64_t interval = 1000000 / rate;
+    uint64_t start = hostTimeMicros();
+    for (uint64_t at = start; at < start + minMicros || steps.size() < minSteps; at += interval) {
+        hostAdvanceTo(at);
+        bool down = sweepPosition < SWEEP_DETENTS;
+        sweepPosition = (sweepPosition + 1) % (2 * SWEEP_DETENTS);
+        sweepValue += down ? -2 : 2;
+        steps.push_back({hostTimeMicros(), deejValue(sweepValue)});
+        turn(down);
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(SETTLE_MICROS));
+    return steps;
+}
+
+static void runBenchmark() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));  // Boot messages and first keyframe
+    injectSteps(1000, WARM_UP_MICROS, 0);  // Threads, caches and the pty settle
+
+    const char* mode = serialProtocol == SERIAL_PROTOCOL_BINARY ? "binary"
+        : serialOutputMode == SERIAL_OUTPUT_EVERY_LOOP ? "ascii, every loop" : "ascii, on change";
+    printf("output: %s\n", mode);
+    printf("%10s %10s %8s %10s %10s %8s %8s %8s %8s %8s %10s\n", "steps/s", "achieved", "steps", "delivered",
+           "own frame", "p50 us", "p90 us", "p99 us", "max us", "frames", "sustained");
+
+    int sustainable = 0;
+    for (int rate : {50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000}) {
+        {
+            std::lock_guard<std::mutex> lock(framesMutex);
+            frames.clear();
+        }
+        std::vector<Step> steps = injectSteps(rate, RUN_MICROS, MIN_SAMPLES);
+
+        std::vector<Frame> received;
+        {
+            std::lock_guard<std::mutex> lock(framesMutex);
+            received = frames;
+        }
+        size_t ownFrames;
+        std::vector<uint64_t> sorted = latencies(steps, received, ownFrames);
+        std::sort(sorted.begin(), sorted.end());
+        uint64_t p99 = percentile(sorted, 0.99);
+        // The injector falls behind at the top rates; this is what it managed
+        double achieved = steps.size() * 1e6 / (steps.back().timeMicros - steps.front().timeMicros + 1000000 / rate);
+        bool sustained = achieved >= MIN_ACHIEVED * rate && sorted.size() == steps.size()
+            && ownFrames >= MIN_OWN_FRAMES * steps.size() && p99 < SUSTAINABLE_P99_MICROS;
+        if (sustained) sustainable = rate;
+
+        printf("%10d %10.0f %8zu %9.1f%% %9.1f%% %8llu %8llu %8llu %8llu %8zu %10s\n", rate, achieved, steps.size(),
+               100.0 * sorted.size() / steps.size(), 100.0 * ownFrames / steps.size(),
+               (unsigned long long)percentile(sorted, 0.5), (unsigned long long)percentile(sorted, 0.9),
+               (unsigned long long)p99, (unsigned long long)(sorted.empty() ? 0 : sorted.back()), received.size(),
+               sustained ? "yes" : "no");
+        fflush(stdout);
+    }
+    printf("max sustainable: %d steps/s (achieved, every step delivered, %.0f%% in frames of their own, "
+           "p99 under %llu us)\n", sustainable, MIN_OWN_FRAMES * 100, (unsigned long long)SUSTAINABLE_P99_MICROS);
+    fflush(stdout);
+    _exit(0);  // The loop and the HAL task threads never return
+}
+int main() {
+    hostUseRealTime();
+
+    int host = posix_openpt(O_RDWR | O_NOCTTY);
+    if (host < 0 || grantpt(host) != 0 || unlockpt(host) != 0) {
+        perror("pty");
+        return 1;
+    }
+    int device = open(ptsname(host), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (device < 0) {
+        perror("pty device");
+        return 1;
+    }
+    // Bytes as written, no line discipline
+    termios raw;
+    tcgetattr(device, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(device, TCSANOW, &raw);
+    fakeSerial.setOutputFd(device);
+
+    initDeejControl();
+    std::thread(readFrames, host).detach();
+    std::thread(runBenchmark).detach();
+    for (;;) {
+        runDeejControl();
+    }
+}
@@ -0,0 +1,101 @@
+// Config parsing at 8, 64 and 256 sliders: time and peak heap for checking a
+// file with scanSliderConfig(), and for a full reload through the control
+// loop, which also sizes the slider pool, labels and frame buffers.
+//
+// Heap use is counted by replacing the global operator new and delete, so it
+// covers everything the sketch allocates on the host.
+
+#include "Bench.h"
+#include "DeejControl.h"
+#include "FakeSerial.h"
+#include "MemoryFs.h"
+#include "SliderConfig.h"
+
+#include <cstddef>
+#include <fcntl.h>
+#include <new>
+#include <stdlib.h>
+#include <string>
+
+static size_t liveBytes = 0;
+static size_t peakBytes = 0;
+
+// Each block carries its size in front, so delete can count it back
+static const size_t HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    char* block = (char*)malloc(size + HEADER);
+    if (!block) throw std::bad_alloc();
+    *(size_t*)block = size;
+    liveBytes += size;
+    if (liveBytes > peakBytes) peakBytes = liveBytes;
+    return block + HEADER;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = (char*)p - HEADER;
+    liveBytes -= *(size_t*)block;
+    free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+static std::string configWithSliders(int count) {
+    std::string json = "{\r\n    \"num_sliders\": " + std::to_string(count) + ",\r\n    \"sliders\": [\r\n";
+    for (int i = 0; i < count; i++) {
+        json += "      { \"name\": \"Application " + std::to_string(i) + "\", \"value\": " + std::to_string(i % 101)
+              + ", \"muted\": false, \"previous_value\": 100 }" + (i < count - 1 ? ",\r\n" : "\r\n");
+    }
+    return json + "    ]\r\n}\r\n";
+}
+
+// Starts counting the peak from what is live now
+static size_t peakStart() {
+    peakBytes = liveBytes;
+    return liveBytes;
+}
+
+int main() {
+    // Serial output kept in the fake would count as heap growth
+    fakeSerial.setOutputFd(open("/dev/null", O_WRONLY));
+    memoryFs.setFile(SLIDER_CONFIG_PATH, configWithSliders(3));
+    initDeejControl();
+    runDeejControl();
+
+    printf("%8s %8s %12s %12s %12s %12s\n", "sliders", "bytes", "scan us", "scan peak", "reload us",
+           "reload peak");
+    for (int count : {8, 64, 256}) {
+        std::string json = configWithSliders(count);
+        memoryFs.setFile("/bench.json", json);
+        const long iterations = 200;
+
+        size_t scanPeak = 0;
+        double scanNs = benchPerCall(iterations, [&](long) {
+            HalFile file = memoryFs.open("/bench.json", "r");
+            SliderConfigSummary summary;
+            size_t base = peakStart();
+            const char* error = scanSliderConfig(file, 1024, summary);
+            if (peakBytes - base > scanPeak) scanPeak = peakBytes - base;
+            benchKeep(error);
+        });
+
+        // Each reload replaces the previous pool, so what stays live is its
+        // size and the peak also holds the one it replaces
+        memoryFs.setFile(SLIDER_CONFIG_PATH, json);
+        size_t reloadPeak = 0;
+        double reloadNs = benchPerCall(iterations, [&](long) {
+            size_t base = peakStart();
+            requestConfigReload();
+            runDeejControl();
+            if (peakBytes - base > reloadPeak) reloadPeak = peakBytes - base;
+        });
+
+        printf("%8d %8zu %12.1f %12zu %12.1f %12zu\n", count, json.size(), scanNs / 1000, scanPeak,
+               reloadNs / 1000, reloadPeak);
+    }
+    return 0;
+}
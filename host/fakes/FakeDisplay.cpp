@@ -0,0 +1,95 @@
+#include "FakeDisplay.h"
+#include <string.h>
+
+FakeDisplay fakeDisplay;
+
+// Stand-in glyph cells: advance width and height above the baseline
+static const int NORMAL_GLYPH_WIDTH = 6;
+static const int NORMAL_GLYPH_HEIGHT = 8;
+static const int SMALL_GLYPH_WIDTH = 5;
+static const int SMALL_GLYPH_HEIGHT = 7;
+
+FakeDisplay::FakeDisplay() : buffer(WIDTH * HEIGHT / 8), panel(WIDTH * HEIGHT / 8) {}
+
+void FakeDisplay::clearBuffer() {
+    memset(buffer.data(), 0, buffer.size());
+    strings.clear();
+}
+
+// Tile rows of 8 pixel rows; each byte is one column of a tile row, LSB on top
+void FakeDisplay::setPixel(int x, int y) {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+    buffer[(y / 8) * WIDTH + x] |= 1 << (y % 8);
+}
+
+bool FakeDisplay::pixel(int x, int y) const {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return false;
+    return buffer[(y / 8) * WIDTH + x] & (1 << (y % 8));
+}
+
+void FakeDisplay::drawStr(int x, int y, const char* text) {
+    strings.push_back(text);
+    int width = font == HAL_FONT_SMALL ? SMALL_GLYPH_WIDTH : NORMAL_GLYPH_WIDTH;
+    int height = font == HAL_FONT_SMALL ? SMALL_GLYPH_HEIGHT : NORMAL_GLYPH_HEIGHT;
+
+    // Each character gets a pattern derived from its code, so different text
+    // gives different pixels; the last column is spacing
+    for (; *text; text++, x += width) {
+        uint8_t c = *text;
+        if (c == ' ') continue;
+        for (int column = 0; column < width - 1; column++) {
+            uint32_t bits = (c * 2654435761u) >> (column * 5);
+            bits |= 1u << (column % height);
+            for (int row = 0; row < height; row++) {
+                if (bits & (1u << row)) setPixel(x + column, y - height + 1 + row);
+            }
+        }
+    }
+}
+
+void FakeDisplay::drawFrame(int x, int y, int width, int height) {
+    for (int i = 0; i < width; i++) {
+        setPixel(x + i, y);
+        setPixel(x + i, y + height - 1);
+    }
+    for (int i = 0; i < height; i++) {
+        setPixel(x, y + i);
+        setPixel(x + width - 1, y + i);
+    }
+}
+
+void FakeDisplay::drawBox(int x, int y, int width, int height) {
+    for (int i = 0; i < width; i++) {
+        for (int j = 0; j < height; j++) {
+            setPixel(x + i, y + j);
+        }
+    }
+}
+
+int FakeDisplay::getStrWidth(const char* text) {
+    return strlen(text) * (font == HAL_FONT_SMALL ? SMALL_GLYPH_WIDTH : NORMAL_GLYPH_WIDTH);
+}
+
+void FakeDisplay::updateDisplayArea(int tileX, int tileY, int tileWidth, int tileHeight) {
+    for (int ty = tileY; ty < tileY + tileHeight; ty++) {
+        size_t offset = (ty * getBufferTileWidth() + tileX) * 8;
+        memcpy(panel.data() + offset, buffer.data() + offset, tileWidth * 8);
+    }
+    areaUpdates++;
+    tilesSent += tileWidth * tileHeight;
+}
+
+void FakeDisplay::sendBuffer() {
+    panel = buffer;
+    fullSends++;
+    tilesSent += getBufferTileWidth() * getBufferTileHeight();
+}
+
+std::string FakeDisplay::text() const {
+    std::string joined;
+    for (size_t i = 0; i < strings.size(); i++) {
+        if (i > 0) joined += " | ";
+        joined += strings[i];
+    }
+    return joined;
+}
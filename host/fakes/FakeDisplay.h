@@ -0,0 +1,54 @@
+#ifndef FAKEDISPLAY_H
+#define FAKEDISPLAY_H
+
+#include "Hal.h"
+#include <string>
+#include <vector>
+
+// 128x64 framebuffer in the u8g2 tile layout, plus a copy of what was last
+// sent to the "panel". Text is drawn with fixed-width stand-in glyphs (the
+// real fonts are not available on the host), and the strings drawn since
+// the last clearBuffer() are kept so traces and tests can read the screen.
+
+class FakeDisplay : public HalDisplay {
+public:
+    FakeDisplay();
+
+    void clearBuffer() override;
+    void setFont(HalFont font) override { this->font = font; }
+    void drawStr(int x, int y, const char* text) override;
+    void drawFrame(int x, int y, int width, int height) override;
+    void drawBox(int x, int y, int width, int height) override;
+    int getStrWidth(const char* text) override;
+    int getDisplayWidth() override { return WIDTH; }
+    uint8_t* getBufferPtr() override { return buffer.data(); }
+    int getBufferTileWidth() override { return WIDTH / 8; }
+    int getBufferTileHeight() override { return HEIGHT / 8; }
+    void updateDisplayArea(int tileX, int tileY, int tileWidth, int tileHeight) override;
+    void sendBuffer() override;
+
+    bool pixel(int x, int y) const;
+    bool panelMatchesBuffer() const { return panel == buffer; }
+
+    // Strings drawn since the last clearBuffer(), joined with " | "
+    std::string text() const;
+
+    static const int WIDTH = 128;
+    static const int HEIGHT = 64;
+
+    unsigned long fullSends = 0;
+    unsigned long areaUpdates = 0;
+    unsigned long tilesSent = 0;
+
+private:
+    void setPixel(int x, int y);
+
+    HalFont font = HAL_FONT_NORMAL;
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> panel;
+    std::vector<std::string> strings;
+};
+
+extern FakeDisplay fakeDisplay;
+
+#endif
@@ -0,0 +1,79 @@
+#include "FakeSerial.h"
+#include "HostHal.h"
+#include <errno.h>
+#include <unistd.h>
+
+FakeSerial fakeSerial;
+
+void FakeSerial::configure(uint32_t baudRate, size_t fifoBytes) {
+    baud = baudRate;
+    fifoSize = fifoBytes;
+}
+
+void FakeSerial::drain() {
+    uint64_t now = hostTimeMicros();
+    while (!fifo.empty() && fifo.front().timeMicros <= now) {
+        output.push_back(fifo.front());
+        fifo.pop_front();
+    }
+}
+
+int FakeSerial::availableForWrite() {
+    if (outputFd >= 0 || fifoSize == 0) {
+        return 256;
+    }
+    drain();
+    return fifoSize - fifo.size();
+}
+
+size_t FakeSerial::write(const uint8_t* data, size_t length) {
+    if (outputFd >= 0) {
+        ssize_t written = ::write(outputFd, data, length);
+        if (written < 0) {
+            return errno == EAGAIN ? 0 : length;  // A closed reader drops the data, like a UART
+        }
+        totalWritten += written;
+        return written;
+    }
+
+    uint64_t now = hostTimeMicros();
+    if (fifoSize == 0) {
+        for (size_t i = 0; i < length; i++) output.push_back({now, data[i]});
+        totalWritten += length;
+        return length;
+    }
+
+    // Start bit, 8 data bits and a stop bit per byte
+    uint64_t byteNanos = 10000000000ull / baud;
+    if (lastDepartureNanos < now * 1000) lastDepartureNanos = now * 1000;
+
+    // Like HardwareSerial, a write waits for room in the FIFO
+    for (size_t i = 0; i < length; i++) {
+        if (fifo.size() >= fifoSize) {
+            hostAdvanceTo(fifo.front().timeMicros);
+            drain();
+        }
+        lastDepartureNanos += byteNanos;
+        fifo.push_back({(lastDepartureNanos + 999) / 1000, data[i]});
+    }
+    totalWritten += length;
+    return length;
+}
+
+int FakeSerial::read() {
+    if (input.empty()) return -1;
+    int c = input.front();
+    input.pop_front();
+    return c;
+}
+
+void FakeSerial::feedInput(const char* text) {
+    while (*text) input.push_back((uint8_t)*text++);
+}
+
+std::vector<SerialByte> FakeSerial::takeOutput() {
+    drain();
+    std::vector<SerialByte> taken;
+    taken.swap(output);
+    return taken;
+}
@@ -0,0 +1,56 @@
+#ifndef FAKESERIAL_H
+#define FAKESERIAL_H
+
+#include "Hal.h"
+#include <deque>
+#include <vector>
+
+// Serial port capture. Written bytes go into a TX FIFO that drains at the
+// baud rate on the host clock, like the ESP32's UART, so availableForWrite()
+// runs out when the loop writes faster than the line can carry, and a write
+// that doesn't fit waits (moving virtual time on). Each byte is captured with
+// the time its last bit left the wire.
+//
+// With an fd set (a pty in the latency benchmark) bytes are written to it
+// straight away instead, non-blocking.
+
+struct SerialByte {
+    uint64_t timeMicros;
+    uint8_t value;
+};
+
+class FakeSerial : public HalSerial {
+public:
+    using HalPrint::write;
+    using HalStream::read;
+    size_t write(const uint8_t* data, size_t length) override;
+    int availableForWrite() override;
+    int available() override { return input.size(); }
+    int read() override;
+    int peek() override { return input.empty() ? -1 : input.front(); }
+
+    // fifoSize 0 means writes never block and bytes leave at once
+    void configure(uint32_t baud, size_t fifoSize);
+    void setOutputFd(int fd) { outputFd = fd; }
+    void feedInput(const char* text);
+
+    // Bytes that have left the wire by now
+    std::vector<SerialByte> takeOutput();
+    size_t bytesWritten() const { return totalWritten; }
+
+private:
+    void drain();
+
+    uint32_t baud = 115200;
+    size_t fifoSize = 128;
+    uint64_t lastDepartureNanos = 0;
+    std::deque<SerialByte> fifo;  // Times are departures, in the future
+    std::vector<SerialByte> output;
+    std::deque<uint8_t> input;
+    int outputFd = -1;
+    size_t totalWritten = 0;
+};
+
+extern FakeSerial fakeSerial;
+
+#endif
@@ -0,0 +1,220 @@
+#include "HostHal.h"
+#include "FakeDisplay.h"
+#include "FakeSerial.h"
+#include "MemoryFs.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int HOST_PINS = 64;
+
+struct HostInterrupt {
+    void (*handler)();
+    int mode;
+};
+
+struct HostTask {
+    HalTaskStep step;
+    uint64_t nextRun;
+};
+
+struct HostAction {
+    std::function<void()> action;
+};
+
+bool realTime = false;
+uint64_t virtualMicros = 0;
+std::chrono::steady_clock::time_point realStart = std::chrono::steady_clock::now();
+
+std::atomic<int> pinLevels[HOST_PINS];
+int pinModes[HOST_PINS];
+HostInterrupt interrupts[HOST_PINS];
+std::mutex interruptMutex;  // Real-time mode: one "interrupt" at a time, as on one core
+
+std::vector<HostTask> tasks;
+std::multimap<uint64_t, HostAction> actions;
+std::vector<std::thread> taskThreads;
+int advanceDepth = 0;  // Time moved by a task, e.g. waiting on serial, runs no other tasks
+
+int hostRestarts = 0;
+
+static struct HostInit {
+    HostInit() {
+        for (int i = 0; i < HOST_PINS; i++) {
+            pinLevels[i] = HAL_HIGH;  // Pulled up, nothing pressed
+            pinModes[i] = -1;
+            interrupts[i] = {nullptr, 0};
+        }
+    }
+} hostInit;
+
+void hostUseRealTime() {
+    realTime = true;
+    realStart = std::chrono::steady_clock::now();
+}
+
+bool hostRealTime() {
+    return realTime;
+}
+
+uint64_t hostTimeMicros() {
+    if (realTime) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - realStart).count();
+    }
+    return virtualMicros;
+}
+
+void hostSchedule(uint64_t timeMicros, std::function<void()> action) {
+    actions.insert({timeMicros, {action}});
+}
+
+void hostAdvanceTo(uint64_t timeMicros) {
+    if (realTime) {
+        uint64_t now = hostTimeMicros();
+        if (timeMicros > now) {
+            std::this_thread::sleep_for(std::chrono::microseconds(timeMicros - now));
+        }
+        return;
+    }
+
+    advanceDepth++;
+    for (;;) {
+        // Whatever comes first, a scripted action or a task. Actions win ties,
+        // so a task sees the pin edges scheduled for its own time.
+        int task = -1;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (task < 0 || tasks[i].nextRun < tasks[task].nextRun) task = i;
+        }
+        uint64_t taskTime = task >= 0 && advanceDepth == 1 ? tasks[task].nextRun : UINT64_MAX;
+        uint64_t actionTime = actions.empty() ? UINT64_MAX : actions.begin()->first;
+
+        if (actionTime <= taskTime && actionTime <= timeMicros) {
+            if (actionTime > virtualMicros) virtualMicros = actionTime;
+            HostAction action = actions.begin()->second;
+            actions.erase(actions.begin());
+            action.action();
+        } else if (taskTime <= timeMicros) {
+            if (taskTime > virtualMicros) virtualMicros = taskTime;
+            unsigned long sleepMs = tasks[task].step();
+            tasks[task].nextRun = virtualMicros + sleepMs * 1000ull;
+        } else {
+            break;
+        }
+    }
+    advanceDepth--;
+    if (timeMicros > virtualMicros) virtualMicros = timeMicros;
+}
+
+void hostAdvance(uint64_t micros) {
+    hostAdvanceTo(hostTimeMicros() + micros);
+}
+
+unsigned long halMillis() {
+    return hostTimeMicros() / 1000;
+}
+
+unsigned long halMicros() {
+    return (uint32_t)hostTimeMicros();
+}
+
+void halDelay(unsigned long ms) {
+    hostAdvance(ms * 1000ull);
+}
+
+uint32_t halCycleCount() {
+    if (realTime) {
+        uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - realStart).count();
+        return nanos * HOST_CYCLES_PER_MICROSECOND / 1000;
+    }
+    return virtualMicros * HOST_CYCLES_PER_MICROSECOND;
+}
+
+uint32_t halCyclesPerMicrosecond() {
+    return HOST_CYCLES_PER_MICROSECOND;
+}
+
+void halPinMode(int pin, int mode) {
+    if (pin >= 0 && pin < HOST_PINS) pinModes[pin] = mode;
+}
+
+int hostPinMode(int pin) {
+    return pin >= 0 && pin < HOST_PINS ? pinModes[pin] : -1;
+}
+
+int halDigitalRead(int pin) {
+    return pin >= 0 && pin < HOST_PINS ? pinLevels[pin].load() : HAL_LOW;
+}
+
+void halAttachInterrupt(int pin, void (*handler)(), int mode) {
+    if (pin >= 0 && pin < HOST_PINS) interrupts[pin] = {handler, mode};
+}
+
+void hostSetPin(int pin, int level) {
+    if (pin < 0 || pin >= HOST_PINS) return;
+    level = level ? HAL_HIGH : HAL_LOW;
+
+    std::lock_guard<std::mutex> lock(interruptMutex);
+    int previous = pinLevels[pin].exchange(level);
+    if (previous == level) return;
+
+    const HostInterrupt& interrupt = interrupts[pin];
+    bool fire = interrupt.mode == HAL_CHANGE
+        || (interrupt.mode == HAL_RISING && level == HAL_HIGH)
+        || (interrupt.mode == HAL_FALLING && level == HAL_LOW);
+    if (interrupt.handler && fire) {
+        interrupt.handler();
+    }
+}
+
+static void runTaskThread(HalTaskStep step) {
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(step()));
+    }
+}
+
+void halStartTask(HalTaskStep step, const char*, uint32_t, int) {
+    if (realTime) {
+        taskThreads.emplace_back(runTaskThread, step);
+        taskThreads.back().detach();
+        return;
+    }
+    tasks.push_back({step, virtualMicros});
+}
+
+HalMutex halCreateMutex() {
+    return new std::mutex();
+}
+
+void halLockMutex(HalMutex mutex) {
+    static_cast<std::mutex*>(mutex)->lock();
+}
+
+void halUnlockMutex(HalMutex mutex) {
+    static_cast<std::mutex*>(mutex)->unlock();
+}
+
+HalDisplay& halDisplay() {
+    return fakeDisplay;
+}
+
+HalFs& halFs() {
+    return memoryFs;
+}
+
+HalSerial& halSerial() {
+    return fakeSerial;
+}
+
+uint32_t halFreeHeap() {
+    return 0;  // Not tracked on the host
+}
+
+void halRestart() {
+    hostRestarts++;
+}
@@ -0,0 +1,40 @@
+#ifndef HOSTHAL_H
+#define HOSTHAL_H
+
+#include "Hal.h"
+#include <functional>
+
+// Host implementation of Hal.h, for building the controller logic on Linux.
+//
+// By default time is virtual: it only moves in halDelay() and hostAdvance(),
+// and background tasks run on it cooperatively, whenever the loop sleeps, as
+// they do below the loop's priority on the device. Scheduled actions (pin
+// edges from a script) run at their exact time, so a run is deterministic.
+//
+// hostUseRealTime() switches to the wall clock, with tasks on threads, for
+// benchmarks that talk to real file descriptors.
+
+const uint32_t HOST_CYCLES_PER_MICROSECOND = 160;  // ESP32-C3 at 160 MHz
+
+// Call before anything else uses the HAL
+void hostUseRealTime();
+bool hostRealTime();
+
+// Virtual time in microseconds, without the 32-bit wrap of halMicros()
+uint64_t hostTimeMicros();
+
+// Moves virtual time forward, running scheduled actions and due tasks on the way
+void hostAdvance(uint64_t micros);
+void hostAdvanceTo(uint64_t timeMicros);
+
+// Runs action when virtual time reaches timeMicros. Actions at the same time run in order.
+void hostSchedule(uint64_t timeMicros, std::function<void()> action);
+
+// Drives an input pin, calling its interrupt handler if the edge matches
+void hostSetPin(int pin, int level);
+int hostPinMode(int pin);  // -1 if never set
+
+// Times halRestart() was called; the host doesn't actually restart
+extern int hostRestarts;
+
+#endif
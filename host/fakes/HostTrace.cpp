@@ -0,0 +1,41 @@
+#include "HostTrace.h"
+#include "DeejTrace.h"
+#include "FakeDisplay.h"
+#include "HostHal.h"
+
+bool hostTraceEnabled = false;
+std::vector<TraceEvent> hostTrace;
+unsigned long tracedTiles = 0;
+
+// The hooks pass the 32-bit halMicros(); the host clock has the full time
+static void record(TraceKind kind, const std::string& data, size_t length, unsigned long tiles = 0) {
+    if (hostTraceEnabled) {
+        hostTrace.push_back({hostTimeMicros(), kind, data, length, tiles});
+    }
+}
+
+void traceSerialFrame(unsigned long, const uint8_t* data, size_t length) {
+    record(TRACE_SERIAL, std::string((const char*)data, length), length);
+}
+
+void traceSerialDrop(unsigned long, const uint8_t* data, size_t length) {
+    record(TRACE_SERIAL_DROP, std::string((const char*)data, length), length);
+}
+
+void traceSerialLog(unsigned long, const char* line, size_t length) {
+    record(TRACE_SERIAL_LOG, std::string(line, length), length);
+}
+
+void traceDisplayFrame(unsigned long, const uint8_t*, size_t length) {
+    unsigned long tiles = fakeDisplay.tilesSent - tracedTiles;
+    tracedTiles = fakeDisplay.tilesSent;
+    record(TRACE_DISPLAY, fakeDisplay.text(), length, tiles);
+}
+
+void traceFsWrite(unsigned long, const char* path, size_t length) {
+    record(TRACE_FS_WRITE, path, length);
+}
+
+void hostTraceNote(const std::string& text) {
+    record(TRACE_NOTE, text, 0);
+}
@@ -0,0 +1,33 @@
+#ifndef HOSTTRACE_H
+#define HOSTTRACE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Records the DeejTrace.h hooks, which deej_core is built with on the host.
+// Nothing is kept until hostTraceEnabled is set.
+
+enum TraceKind {
+    TRACE_SERIAL,        // data is the frame
+    TRACE_SERIAL_DROP,   // data is the frame that was replaced
+    TRACE_SERIAL_LOG,    // data is the log line
+    TRACE_DISPLAY,       // data is the screen text, tiles how many were sent
+    TRACE_FS_WRITE,      // data is the path, length the bytes written
+    TRACE_NOTE           // Anything the harness wants in the trace, in data
+};
+
+struct TraceEvent {
+    uint64_t timeMicros;
+    TraceKind kind;
+    std::string data;
+    size_t length;
+    unsigned long tiles;
+};
+
+extern bool hostTraceEnabled;
+extern std::vector<TraceEvent> hostTrace;
+
+void hostTraceNote(const std::string& text);
+
+#endif
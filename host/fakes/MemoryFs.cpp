@@ -0,0 +1,109 @@
+#include "MemoryFs.h"
+#include <string.h>
+
+MemoryFs memoryFs;
+
+class MemoryFile : public HalFileImpl {
+public:
+    MemoryFile(MemoryFs& fs, std::shared_ptr<std::vector<uint8_t>> data, bool writable, size_t position)
+        : fs(fs), data(data), writable(writable), position(position) {}
+
+    size_t write(const uint8_t* bytes, size_t length) override {
+        if (!writable || !data) return 0;
+        fs.writeCalls++;
+        length = fs.takeBudget(length);
+        if (position + length > data->size()) data->resize(position + length);
+        memcpy(data->data() + position, bytes, length);
+        position += length;
+        fs.bytesWritten += length;
+        return length;
+    }
+
+    size_t read(uint8_t* bytes, size_t length) override {
+        if (!data || position >= data->size()) return 0;
+        if (length > data->size() - position) length = data->size() - position;
+        memcpy(bytes, data->data() + position, length);
+        position += length;
+        return length;
+    }
+
+    int peek() override {
+        return data && position < data->size() ? (*data)[position] : -1;
+    }
+
+    int available() override {
+        return data && position < data->size() ? data->size() - position : 0;
+    }
+
+    bool seek(size_t to) override {
+        if (!data || to > data->size()) return false;
+        position = to;
+        return true;
+    }
+
+    size_t size() override {
+        return data ? data->size() : 0;
+    }
+
+    void close() override {
+        data.reset();
+    }
+
+private:
+    MemoryFs& fs;
+    std::shared_ptr<std::vector<uint8_t>> data;
+    bool writable;
+    size_t position;
+};
+
+size_t MemoryFs::takeBudget(size_t length) {
+    if (writeBudget < 0) return length;
+    if ((long)length > writeBudget) length = writeBudget;
+    writeBudget -= length;
+    return length;
+}
+
+HalFile MemoryFs::open(const char* path, const char* mode) {
+    auto found = files.find(path);
+    if (mode[0] == 'r') {
+        if (found == files.end()) return HalFile();
+        return HalFile(std::make_shared<MemoryFile>(*this, found->second, false, 0));
+    }
+
+    if (found == files.end() || mode[0] == 'w') {
+        // A replaced file keeps its data for handles that still have it open
+        files[path] = std::make_shared<std::vector<uint8_t>>();
+    }
+    std::shared_ptr<std::vector<uint8_t>> data = files[path];
+    return HalFile(std::make_shared<MemoryFile>(*this, data, true, data->size()));
+}
+
+bool MemoryFs::exists(const char* path) {
+    return files.count(path) > 0;
+}
+
+bool MemoryFs::remove(const char* path) {
+    return files.erase(path) > 0;
+}
+
+bool MemoryFs::rename(const char* from, const char* to) {
+    auto found = files.find(from);
+    if (found == files.end() || files.count(to)) return false;
+    files[to] = found->second;
+    files.erase(from);
+    return true;
+}
+
+std::vector<uint8_t>* MemoryFs::file(const std::string& path) {
+    auto found = files.find(path);
+    return found == files.end() ? nullptr : found->second.get();
+}
+
+void MemoryFs::setFile(const std::string& path, const std::string& contents) {
+    files[path] = std::make_shared<std::vector<uint8_t>>(contents.begin(), contents.end());
+}
+
+std::string MemoryFs::contents(const std::string& path) {
+    std::vector<uint8_t>* data = file(path);
+    return data ? std::string(data->begin(), data->end()) : std::string();
+}
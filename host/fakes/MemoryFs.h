@@ -0,0 +1,45 @@
+#ifndef MEMORYFS_H
+#define MEMORYFS_H
+
+#include "Hal.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// In-memory filesystem with SPIFFS's behaviour where the controller relies on
+// it: "w" truncates at open, rename fails if the target exists.
+//
+// For fault injection, setWriteBudget(n) lets only n more bytes reach any
+// file; after that writes store nothing and return short, as if power was
+// cut mid-write. Files keep whatever made it out.
+
+class MemoryFs : public HalFs {
+public:
+    HalFile open(const char* path, const char* mode) override;
+    bool exists(const char* path) override;
+    bool remove(const char* path) override;
+    bool rename(const char* from, const char* to) override;
+
+    void clear() { files.clear(); }
+    void setWriteBudget(long bytes) { writeBudget = bytes; }  // -1 for no limit
+    bool budgetSpent() const { return writeBudget == 0; }
+
+    // Direct access for tests; contents are shared with open handles
+    std::vector<uint8_t>* file(const std::string& path);
+    void setFile(const std::string& path, const std::string& contents);
+    std::string contents(const std::string& path);
+
+    unsigned long bytesWritten = 0;
+    unsigned long writeCalls = 0;
+
+private:
+    friend class MemoryFile;
+    size_t takeBudget(size_t length);
+
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+    long writeBudget = -1;
+};
+
+extern MemoryFs memoryFs;
+
+#endif
@@ -0,0 +1,222 @@
+#include "DeejSim.h"
+#include "DeejControl.h"
+#include "HostHal.h"
+#include "MemoryFs.h"
+#include "SerialTx.h"
+#include "SliderConfig.h"
+
+#include <fstream>
+#include <sstream>
+
+extern int wifiSetupModeEntries;
+
+// Contact bounce: this long between chatter edges
+const unsigned long BOUNCE_MICROS = 50;
+
+// Where the scheduled input leaves each encoder's pins, so the next turn
+// continues from there
+struct SimEncoder {
+    int clkPin;
+    int dtPin;
+    bool clk;
+    bool dt;
+    uint64_t busyUntil;  // Time of the last scheduled edge
+};
+
+static SimEncoder simEncoders[2] = {
+    {ENCODER1_CLK, ENCODER1_DT, true, true, 0},
+    {ENCODER2_CLK, ENCODER2_DT, true, true, 0},
+};
+
+static void scheduleEdge(int pin, bool level, uint64_t time, int bounces) {
+    // Chatter settles on the new level: new, old, new, old, ..., new
+    for (int i = 0; i < bounces; i++) {
+        uint64_t at = time - (bounces - i) * 2 * BOUNCE_MICROS;
+        hostSchedule(at, [pin, level]() { hostSetPin(pin, level); });
+        hostSchedule(at + BOUNCE_MICROS, [pin, level]() { hostSetPin(pin, !level); });
+    }
+    hostSchedule(time, [pin, level]() { hostSetPin(pin, level); });
+}
+
+void simBoot() {
+    hostTraceEnabled = true;
+    hostTraceNote("boot");
+    initDeejControl();
+}
+
+// The main.ino loop, without WiFi
+void simRun(unsigned long ms) {
+    uint64_t end = hostTimeMicros() + ms * 1000ull;
+    while (hostTimeMicros() < end) {
+        int entries = wifiSetupModeEntries;
+        if (inWifiSetupMode) {
+            serviceSerialTx();
+            halDelay(1);
+        } else {
+            runDeejControl();
+        }
+        if (wifiSetupModeEntries != entries) {
+            hostTraceNote("setup mode");
+        }
+    }
+}
+
+// Half-cycle encoders step on every second edge. Clockwise leads with DT:
+// 11 -> 10 -> 00 for one detent, then 00 -> 01 -> 11.
+void simTurn(int encoder, int detents, unsigned long intervalMicros, int bounces) {
+    SimEncoder& e = simEncoders[encoder - 1];
+    uint64_t start = hostTimeMicros() > e.busyUntil ? hostTimeMicros() : e.busyUntil;
+    unsigned long edgeGap = intervalMicros / 3;
+    if (edgeGap > 2000) edgeGap = 2000;
+
+    bool clockwise = detents > 0;
+    for (int i = 0; i < (clockwise ? detents : -detents); i++) {
+        uint64_t detentTime = start + (i + 1) * (uint64_t)intervalMicros;
+        int firstPin = clockwise ? e.dtPin : e.clkPin;
+        int secondPin = clockwise ? e.clkPin : e.dtPin;
+        bool level = !e.clk;  // Both pins move to the level CLK doesn't have yet
+        scheduleEdge(firstPin, level, detentTime - edgeGap, bounces);
+        scheduleEdge(secondPin, level, detentTime, bounces);
+        e.clk = e.dt = level;
+        e.busyUntil = detentTime;
+    }
+}
+
+void simPress(int button, unsigned long holdMicros, int bounces) {
+    int pin = button == 1 ? ENCODER1_SW : ENCODER2_SW;
+    uint64_t now = hostTimeMicros() + bounces * 2 * BOUNCE_MICROS;
+    scheduleEdge(pin, false, now, bounces);
+    scheduleEdge(pin, true, now + holdMicros, bounces);
+}
+
+static bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+bool runSimScript(const std::string& script, const std::string& baseDir, std::string& error) {
+    std::istringstream lines(script);
+    std::string line;
+    int lineNumber = 0;
+    bool booted = false;
+
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        std::istringstream words(line);
+        std::string command;
+        if (!(words >> command) || command[0] == '#') continue;
+
+        bool ok = true;
+        if (command == "config") {
+            std::string file, contents;
+            ok = (words >> file) && !booted && readFile(baseDir + "/" + file, contents);
+            if (ok) memoryFs.setFile(SLIDER_CONFIG_PATH, contents);
+        } else if (command == "boot") {
+            ok = !booted;
+            booted = true;
+            if (ok) simBoot();
+        } else if (command == "turn" || command == "press") {
+            int id = 0;
+            long amount = 0;
+            double ms = 0;
+            std::string option;
+            int bounces = 0;
+            ok = booted && (words >> id >> amount) && id >= 1 && id <= 2;
+            if (command == "turn") ok = ok && (words >> ms) && ms > 0;
+            if (ok && (words >> option)) ok = option == "bounce" && (words >> bounces);
+            if (ok && command == "turn") simTurn(id, amount, ms * 1000, bounces);
+            if (ok && command == "press") simPress(id, amount * 1000, bounces);
+        } else if (command == "wait") {
+            unsigned long ms = 0;
+            ok = booted && (words >> ms);
+            if (ok) simRun(ms);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            error = "line " + std::to_string(lineNumber) + ": cannot run \"" + line + "\"";
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string quoteFrame(const std::string& data) {
+    bool text = true;
+    for (char c : data) {
+        if ((c < 0x20 || c > 0x7E) && c != '\r' && c != '\n') text = false;
+    }
+
+    std::string quoted;
+    char hex[4];
+    if (!text) {
+        for (char c : data) {
+            snprintf(hex, sizeof(hex), "%02x", (uint8_t)c);
+            quoted += hex;
+        }
+        return quoted;
+    }
+
+    quoted = "\"";
+    for (char c : data) {
+        if (c == '\r') quoted += "\\r";
+        else if (c == '\n') quoted += "\\n";
+        else quoted += c;
+    }
+    return quoted + "\"";
+}
+
+std::string formatTrace(const std::vector<TraceEvent>& trace) {
+    std::string text;
+    char line[64];
+    unsigned long frames = 0, frameBytes = 0, drops = 0, logLines = 0, displayFrames = 0, tiles = 0;
+    unsigned long fsWrites = 0, fsBytes = 0;
+
+    for (const TraceEvent& event : trace) {
+        snprintf(line, sizeof(line), "%10.3f ", event.timeMicros / 1000.0);
+        text += line;
+        switch (event.kind) {
+            case TRACE_SERIAL:
+                text += "serial " + quoteFrame(event.data);
+                frames++;
+                frameBytes += event.length;
+                break;
+            case TRACE_SERIAL_DROP:
+                text += "serial dropped " + quoteFrame(event.data);
+                drops++;
+                break;
+            case TRACE_SERIAL_LOG:
+                text += "serial log " + quoteFrame(event.data);
+                logLines++;
+                break;
+            case TRACE_DISPLAY:
+                text += "display " + std::to_string(event.tiles) + " tiles \"" + event.data + "\"";
+                displayFrames++;
+                tiles += event.tiles;
+                break;
+            case TRACE_FS_WRITE:
+                text += "fs " + event.data + " " + std::to_string(event.length) + " bytes";
+                fsWrites++;
+                fsBytes += event.length;
+                break;
+            case TRACE_NOTE:
+                text += event.data;
+                break;
+        }
+        text += "\n";
+    }
+
+    snprintf(line, sizeof(line), "serial: %lu frames, %lu bytes, %lu dropped, %lu log lines\n",
+             frames, frameBytes, drops, logLines);
+    text += line;
+    snprintf(line, sizeof(line), "display: %lu frames, %lu tiles\n", displayFrames, tiles);
+    text += line;
+    snprintf(line, sizeof(line), "fs: %lu writes, %lu bytes\n", fsWrites, fsBytes);
+    text += line;
+    return text;
+}
@@ -0,0 +1,38 @@
+#ifndef DEEJSIM_H
+#define DEEJSIM_H
+
+#include "HostTrace.h"
+#include <string>
+
+// Drives the controller the way main.ino does, on the virtual clock, with
+// scripted encoder and button input. Input is scheduled ahead from the
+// current time; simRun() then runs loop passes while virtual time moves on,
+// so every edge reaches the ISRs at its exact time.
+//
+// Scripts (host/sim/scenarios/*.sim) are one command per line:
+//
+//   config <file>                      Use this sliders_config.json (before boot)
+//   boot                               initDeejControl()
+//   turn <encoder> <detents> <ms> [bounce <n>]
+//                                      Detents every ms, clockwise if positive;
+//                                      each edge preceded by n contact bounces
+//   press <button> <hold ms> [bounce <n>]
+//   wait <ms>                          Run the loop; input scheduled so far happens
+//   # comment
+//
+// The trace holds every serial frame and log line, display frame and
+// filesystem write with its time, then a summary.
+
+// Encoders and buttons are numbered 1 and 2, as in DeejControl
+void simBoot();
+void simRun(unsigned long ms);
+void simTurn(int encoder, int detents, unsigned long intervalMicros, int bounces = 0);
+void simPress(int button, unsigned long holdMicros, int bounces = 0);
+
+// Runs a script from boot, returning false with error set if it is invalid.
+// Relative config paths are taken from baseDir.
+bool runSimScript(const std::string& script, const std::string& baseDir, std::string& error);
+
+std::string formatTrace(const std::vector<TraceEvent>& trace);
+
+#endif
@@ -0,0 +1,82 @@
+// Runs one simulator scenario and compares its trace with the golden file
+// next to it (same name, .golden instead of .sim).
+//
+//   deej_sim scenarios/fast_spin.sim            Fails and shows the first difference
+//   deej_sim scenarios/fast_spin.sim --update   Rewrites the golden file
+//   deej_sim scenarios/fast_spin.sim --print    Prints the trace
+
+#include "DeejSim.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+static std::string readAll(const std::string& path, bool& ok) {
+    std::ifstream in(path, std::ios::binary);
+    ok = (bool)in;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <scenario.sim> [--update | --print]\n";
+        return 2;
+    }
+    std::string scenario = argv[1];
+    bool update = argc > 2 && strcmp(argv[2], "--update") == 0;
+    bool print = argc > 2 && strcmp(argv[2], "--print") == 0;
+
+    bool ok;
+    std::string script = readAll(scenario, ok);
+    if (!ok) {
+        std::cerr << "cannot read " << scenario << "\n";
+        return 2;
+    }
+
+    size_t slash = scenario.find_last_of('/');
+    std::string baseDir = slash == std::string::npos ? "." : scenario.substr(0, slash);
+    std::string error;
+    if (!runSimScript(script, baseDir, error)) {
+        std::cerr << scenario << ": " << error << "\n";
+        return 2;
+    }
+    std::string trace = formatTrace(hostTrace);
+
+    std::string goldenPath = scenario.substr(0, scenario.rfind('.')) + ".golden";
+    if (print) {
+        std::cout << trace;
+        return 0;
+    }
+    if (update) {
+        std::ofstream(goldenPath, std::ios::binary) << trace;
+        std::cout << "wrote " << goldenPath << "\n";
+        return 0;
+    }
+
+    std::string golden = readAll(goldenPath, ok);
+    if (!ok) {
+        std::cerr << "no golden trace at " << goldenPath << " (run with --update)\n";
+        return 1;
+    }
+    if (golden == trace) {
+        return 0;
+    }
+
+    std::istringstream expected(golden), actual(trace);
+    std::string expectedLine, actualLine;
+    for (int line = 1;; line++) {
+        bool more = (bool)std::getline(expected, expectedLine);
+        bool moreActual = (bool)std::getline(actual, actualLine);
+        if (!more && !moreActual) break;
+        if (!more || !moreActual || expectedLine != actualLine) {
+            std::cerr << goldenPath << ":" << line << ": trace differs\n"
+                      << "  expected: " << (more ? expectedLine : "(end)") << "\n"
+                      << "  actual:   " << (moreActual ? actualLine : "(end)") << "\n";
+            break;
+        }
+    }
+    return 1;
+}
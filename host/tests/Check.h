@@ -0,0 +1,47 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+#include <string>
+
+// Minimal test registry for the host tests. Each test file is one executable:
+//
+//   TEST(frameMatchesStringPath) {
+//       CHECK_EQ(encode(...), expected);
+//   }
+//
+// A failed check reports and the test carries on; the exit code is the
+// number of failed tests.
+
+typedef void (*TestFunction)();
+
+struct TestRegistration {
+    TestRegistration(const char* name, TestFunction function);
+};
+
+void checkFailed(const char* file, int line, const std::string& message);
+
+inline std::string checkText(const std::string& value) { return "\"" + value + "\""; }
+inline std::string checkText(const char* value) { return checkText(std::string(value ? value : "(null)")); }
+inline std::string checkText(bool value) { return value ? "true" : "false"; }
+template <typename T>
+std::string checkText(const T& value) { return std::to_string(value); }
+
+#define TEST(name)                                                      \
+    static void name();                                                 \
+    static TestRegistration name##Registration(#name, name);            \
+    static void name()
+
+#define CHECK(condition) do {                                           \
+        if (!(condition)) checkFailed(__FILE__, __LINE__, #condition);  \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) do {                                 \
+        auto checkActual = (actual);                                    \
+        auto checkExpected = (expected);                                \
+        if (!(checkActual == checkExpected))                            \
+            checkFailed(__FILE__, __LINE__, std::string(#actual) + " is " + checkText(checkActual) \
+                        + ", expected " + checkText(checkExpected));    \
+    } while (0)
+
+#endif
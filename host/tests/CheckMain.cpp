@@ -0,0 +1,42 @@
+#include "Check.h"
+#include <string.h>
+#include <vector>
+
+struct RegisteredTest {
+    const char* name;
+    TestFunction function;
+};
+
+static std::vector<RegisteredTest>& registeredTests() {
+    static std::vector<RegisteredTest> tests;
+    return tests;
+}
+
+static int currentFailures = 0;
+
+TestRegistration::TestRegistration(const char* name, TestFunction function) {
+    registeredTests().push_back({name, function});
+}
+
+void checkFailed(const char* file, int line, const std::string& message) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+    currentFailures++;
+}
+
+// Runs every test, or only those named on the command line
+int main(int argc, char** argv) {
+    int failed = 0;
+    for (const RegisteredTest& test : registeredTests()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], test.name) == 0) selected = true;
+        }
+        if (!selected) continue;
+
+        currentFailures = 0;
+        test.function();
+        printf("%s %s\n", currentFailures ? "FAIL" : "ok  ", test.name);
+        if (currentFailures) failed++;
+    }
+    return failed;
+}
@@ -0,0 +1,114 @@
+// The acceleration curve end to end: detents at a steady rate through the
+// decoder and the control loop, read back as the volume on the display.
+// Encoder 1 is reversed, so counter-clockwise (negative) turns raise it.
+
+#include "Check.h"
+#include "DeejControl.h"
+#include "DeejSim.h"
+#include "FakeDisplay.h"
+#include "MemoryFs.h"
+#include "SliderConfig.h"
+
+#include <stdlib.h>
+
+// The curve from host/sim/scenarios/accel_config.json
+static const char* const ACCEL_CONFIG =
+    "{ \"num_sliders\": 2, \"sliders\": ["
+    "  { \"name\": \"Master\", \"value\": 50, \"muted\": false, \"previous_value\": 50 },"
+    "  { \"name\": \"Music\", \"value\": 80, \"muted\": false, \"previous_value\": 80 } ],"
+    "  \"acceleration\": ["
+    "  { \"interval_ms\": 120, \"step\": 1 }, { \"interval_ms\": 60, \"step\": 2 },"
+    "  { \"interval_ms\": 30, \"step\": 5 }, { \"interval_ms\": 10, \"step\": 10 } ] }";
+
+static const char* const FLAT_CONFIG =
+    "{ \"num_sliders\": 2, \"sliders\": ["
+    "  { \"name\": \"Master\", \"value\": 50, \"muted\": false, \"previous_value\": 50 },"
+    "  { \"name\": \"Music\", \"value\": 80, \"muted\": false, \"previous_value\": 80 } ] }";
+
+static int volume() {
+    std::string text = fakeDisplay.text();
+    size_t bar = text.rfind("| ");
+    return bar == std::string::npos ? -1 : atoi(text.c_str() + bar + 2);
+}
+
+// Every case starts from its own config at volume 50, with no saved state
+static void loadConfig(const char* config) {
+    static bool booted = false;
+    memoryFs.clear();
+    memoryFs.setFile(SLIDER_CONFIG_PATH, config);
+    if (booted) {
+        requestConfigReload();
+    } else {
+        simBoot();
+        booted = true;
+    }
+    simRun(200);
+}
+
+// Turns after a pause, so the first detent is always at the slowest step
+static int volumeChange(int detents, unsigned long intervalMs) {
+    simRun(500);
+    int before = volume();
+    simTurn(1, detents, intervalMs * 1000);
+    simRun(detents * (detents < 0 ? -intervalMs : intervalMs) + 200);
+    return volume() - before;
+}
+
+TEST(bootsWithTheCurve) {
+    loadConfig(ACCEL_CONFIG);
+    CHECK_EQ(volume(), 50);
+}
+
+TEST(slowerThanTheCurveMovesOneUnit) {
+    loadConfig(ACCEL_CONFIG);
+    CHECK_EQ(volumeChange(-5, 200), 5);
+    CHECK_EQ(volumeChange(5, 120), -5);
+}
+
+TEST(curvePointsSetTheStep) {
+    loadConfig(ACCEL_CONFIG);
+    // First detent 1, then four at the point's step
+    CHECK_EQ(volumeChange(-5, 60), 1 + 4 * 2);
+    CHECK_EQ(volumeChange(5, 30), -(1 + 4 * 5));
+    CHECK_EQ(volumeChange(-3, 10), 1 + 2 * 10);
+}
+
+TEST(stepIsInterpolatedBetweenPoints) {
+    // The curve falls with the interval; off-midpoint intervals pin the rounding
+    loadConfig(ACCEL_CONFIG);
+    // 14 ms, from 10 ms (10) to 30 ms (5): 9
+    CHECK_EQ(volumeChange(-3, 14), 1 + 2 * 9);
+    // 40 ms, from 30 ms (5) to 60 ms (2): 4
+    CHECK_EQ(volumeChange(4, 40), -(1 + 3 * 4));
+    // 50 ms: 3
+    CHECK_EQ(volumeChange(-4, 50), 1 + 3 * 3);
+    // 100 ms, from 60 ms (2) to 120 ms (1): 1.33, so 1
+    CHECK_EQ(volumeChange(4, 100), -(1 + 3 * 1));
+}
+
+TEST(halfwayStepsRoundTowardTheSlowerPoint) {
+    loadConfig(ACCEL_CONFIG);
+    // 45 ms is halfway from 30 ms (5) to 60 ms (2): 3.5, rounded to 3
+    CHECK_EQ(volumeChange(-4, 45), 1 + 3 * 3);
+    // 90 ms is halfway from 60 ms (2) to 120 ms (1): 1.5, rounded to 1
+    CHECK_EQ(volumeChange(4, 90), -(1 + 3 * 1));
+}
+
+TEST(fasterThanTheCurveKeepsTheFastestStep) {
+    loadConfig(ACCEL_CONFIG);
+    CHECK_EQ(volumeChange(-3, 5), 1 + 2 * 10);
+}
+
+TEST(volumeStopsAtTheEnds) {
+    loadConfig(ACCEL_CONFIG);
+    volumeChange(-12, 10);
+    CHECK_EQ(volume(), 100);
+    volumeChange(12, 10);
+    CHECK_EQ(volume(), 0);
+}
+
+TEST(withoutACurveEveryDetentIsTheSame) {
+    loadConfig(FLAT_CONFIG);
+    CHECK_EQ(volumeChange(-5, 200), 5 * 2);
+    CHECK_EQ(volumeChange(-5, 10), 5 * 2);
+}
@@ -0,0 +1,95 @@
+// Button gestures from raw edges, several of them arriving between two loop
+// passes, with contact bounce.
+
+#include "Check.h"
+#include "Buttons.h"
+
+#include <string>
+
+static std::string gestures;
+
+static void record(uint8_t, ButtonGesture gesture) {
+    static const char* names[] = {"press", "release", "click", "double", "long"};
+    if (!gestures.empty()) gestures += " ";
+    gestures += names[gesture];
+}
+
+static Button freshButton() {
+    Button button;
+    initButton(button, ButtonConfig{30, 300, 1000});
+    gestures.clear();
+    return button;
+}
+
+TEST(pressAndReleaseInOnePassAreBothSeen) {
+    Button button = freshButton();
+    feedButtonEdge(button, true, 100);
+    feedButtonEdge(button, false, 180);
+    updateButton(button, 1, 200, record);
+    CHECK_EQ(gestures, std::string("press release"));
+
+    updateButton(button, 1, 479, record);
+    CHECK_EQ(gestures, std::string("press release"));
+    updateButton(button, 1, 480, record);  // doubleClickMs after the release, not after the pass
+    CHECK_EQ(gestures, std::string("press release click"));
+}
+
+TEST(doubleClickInOnePass) {
+    Button button = freshButton();
+    feedButtonEdge(button, true, 100);
+    feedButtonEdge(button, false, 150);
+    feedButtonEdge(button, true, 250);
+    feedButtonEdge(button, false, 300);
+    updateButton(button, 1, 310, record);
+    CHECK_EQ(gestures, std::string("press release press release double"));
+}
+
+TEST(bounceWithinDebounceIsIgnored) {
+    Button button = freshButton();
+    // Chatter on press and on release, 2 ms apart
+    bool levels[] = {true, false, true, false, true};
+    for (int i = 0; i < 5; i++) feedButtonEdge(button, levels[i], 100 + 2 * i);
+    updateButton(button, 1, 120, record);
+    for (int i = 0; i < 5; i++) feedButtonEdge(button, !levels[i], 200 + 2 * i);
+    updateButton(button, 1, 220, record);
+    CHECK_EQ(gestures, std::string("press release"));
+}
+
+TEST(levelAfterBounceIsTakenOnceSettled) {
+    Button button = freshButton();
+    // Bounce ends released, inside the debounce window of the press
+    feedButtonEdge(button, true, 100);
+    feedButtonEdge(button, false, 105);
+    updateButton(button, 1, 110, record);
+    CHECK_EQ(gestures, std::string("press"));
+    updateButton(button, 1, 130, record);
+    CHECK_EQ(gestures, std::string("press release"));
+}
+
+TEST(longPressIsReportedBeforeItsRelease) {
+    Button button = freshButton();
+    feedButtonEdge(button, true, 100);
+    updateButton(button, 1, 100, record);
+    // Loop stalled: the long press timeout and the release arrive together
+    feedButtonEdge(button, false, 1500);
+    updateButton(button, 1, 1600, record);
+    updateButton(button, 1, 3000, record);
+    CHECK_EQ(gestures, std::string("press long release"));
+}
+
+TEST(edgeStampedBeforeLastUpdate) {
+    Button button = freshButton();
+    updateButton(button, 1, 1000, record);
+    feedButtonEdge(button, true, 999);
+    updateButton(button, 1, 1001, record);
+    updateButton(button, 1, 1500, record);
+    CHECK_EQ(gestures, std::string("press"));
+}
+
+TEST(fullQueueKeepsTheFinalLevel) {
+    Button button = freshButton();
+    for (int i = 0; i < 3 * BUTTON_EDGE_QUEUE + 1; i++) feedButtonEdge(button, i % 2 == 0, 100 + i);
+    updateButton(button, 1, 200, record);
+    CHECK_EQ(gestures, std::string("press"));
+    CHECK(button.down);
+}
@@ -0,0 +1,62 @@
+// The frame encoder against the String-built line it replaced, for every
+// slider value and every slider count up to SLIDER_PACKET_MAX_SLIDERS. Text
+// frames have no slider limit of their own; that is the binary protocol's.
+
+#include "Check.h"
+#include "DeejFrame.h"
+#include "SliderProtocol.h"
+
+#include <string>
+#include <vector>
+
+// The old path: String(map(value, 0, 100, 0, 1023)) joined with '|', then println
+static std::string referenceFrame(const int* values, int count) {
+    std::string line;
+    for (int i = 0; i < count; i++) {
+        line += std::to_string(values[i] * 1023L / 100);
+        if (i < count - 1) line += "|";
+    }
+    return line + "\r\n";
+}
+
+static std::string encode(const int* values, int count) {
+    std::vector<char> buf(deejFrameBufferSize(count));
+    size_t length = encodeDeejFrame(buf.data(), buf.size(), values, count);
+    CHECK_EQ(buf[length], '\0');
+    return std::string(buf.data(), length);
+}
+
+TEST(everyValueMatchesMap) {
+    for (int value = 0; value <= 100; value++) {
+        CHECK_EQ((long)deejValue(value), value * 1023L / 100);
+    }
+    CHECK_EQ((int)deejValue(-5), 0);
+    CHECK_EQ((int)deejValue(250), 1023);
+}
+
+TEST(framesMatchTheStringPath) {
+    int values[SLIDER_PACKET_MAX_SLIDERS];
+    for (int count = 1; count <= SLIDER_PACKET_MAX_SLIDERS; count++) {
+        for (int i = 0; i < count; i++) values[i] = (i * 37 + count * 11) % 101;
+        CHECK_EQ(encode(values, count), referenceFrame(values, count));
+    }
+}
+
+TEST(widestFrameFitsItsBuffer) {
+    int values[16];
+    for (int i = 0; i < 16; i++) values[i] = 100;
+    std::string frame = encode(values, 16);
+    CHECK_EQ(frame.size(), deejFrameBufferSize(16) - 2);  // Less the '|' after the last value and the terminator
+    CHECK_EQ(frame, referenceFrame(values, 16));
+}
+
+TEST(emptyFrameIsJustTheLineEnd) {
+    CHECK_EQ(encode(nullptr, 0), std::string("\r\n"));
+}
+
+TEST(shortBufferIsRefused) {
+    int values[3] = {0, 50, 100};
+    char buf[32];
+    CHECK_EQ(encodeDeejFrame(buf, deejFrameBufferSize(3) - 1, values, 3), (size_t)0);
+    CHECK_EQ(encodeDeejFrame(buf, sizeof(buf), values, -1), (size_t)0);
+}
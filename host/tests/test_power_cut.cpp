@@ -0,0 +1,129 @@
+// Power cut at every byte of a slider state write: whatever reaches flash,
+// loading afterwards must give either the state before the write or after it,
+// never something in between and never nothing.
+
+#include "Check.h"
+#include "DeejControl.h"
+#include "DeejSim.h"
+#include "MemoryFs.h"
+#include "SliderJournal.h"
+#include "SliderPool.h"
+#include "SliderState.h"
+
+extern SliderPool sliders;
+
+static const char* const NAMES[] = {"Master", "System", "Mic"};
+
+struct State {
+    int values[3];
+    bool muted[3];
+    int previousValues[3];
+
+    explicit State(int value) {
+        for (int i = 0; i < 3; i++) {
+            values[i] = value + i;
+            muted[i] = value % 2;
+            previousValues[i] = value - i;
+        }
+    }
+    bool operator==(const State& other) const {
+        for (int i = 0; i < 3; i++) {
+            if (values[i] != other.values[i] || muted[i] != other.muted[i]
+                || previousValues[i] != other.previousValues[i]) return false;
+        }
+        return true;
+    }
+};
+
+// What a reboot would restore: the newest snapshot, then the journal
+static bool loadState(State& state, uint32_t layout) {
+    if (!loadSliderState(state.values, state.muted, state.previousValues, 3, layout)) return false;
+    replayJournal(state.values, state.muted, state.previousValues, 3, layout);
+    return true;
+}
+
+TEST(snapshotCutAtEveryByte) {
+    uint32_t layout = sliderLayoutId(NAMES, 3);
+    const long size = 16 + 3 * 3 + 2;
+    State before(10), after(20), next(30);
+
+    for (long cut = 0; cut <= size; cut++) {
+        memoryFs.clear();
+        CHECK(saveSliderState(before.values, before.muted, before.previousValues, 3, layout));
+
+        memoryFs.setWriteBudget(cut);
+        bool saved = saveSliderState(after.values, after.muted, after.previousValues, 3, layout);
+        memoryFs.setWriteBudget(-1);
+        CHECK_EQ(saved, cut == size);
+
+        State loaded(0);
+        CHECK(loadState(loaded, layout));
+        CHECK(loaded == (cut == size ? after : before));
+
+        // The next save must not overwrite the only good slot
+        CHECK(saveSliderState(next.values, next.muted, next.previousValues, 3, layout));
+        State reloaded(0);
+        CHECK(loadState(reloaded, layout));
+        CHECK(reloaded == next);
+    }
+}
+
+TEST(journalCutAtEveryByte) {
+    uint32_t layout = sliderLayoutId(NAMES, 3);
+    const long size = 3 * JOURNAL_RECORD_SIZE;
+    State base(10), first(20), second(40);
+    bool all[3] = {true, true, true};
+
+    for (long cut = 0; cut <= size; cut++) {
+        memoryFs.clear();
+        CHECK(saveSliderState(base.values, base.muted, base.previousValues, 3, layout));
+        CHECK(appendJournal(all, first.values, first.muted, first.previousValues, 3, layout));
+
+        memoryFs.setWriteBudget(cut);
+        bool appended = appendJournal(all, second.values, second.muted, second.previousValues, 3, layout);
+        memoryFs.setWriteBudget(-1);
+        CHECK_EQ(appended, cut == size);
+
+        // Whole records are applied, the torn one and anything after it are not
+        State loaded(0);
+        CHECK(loadState(loaded, layout));
+        int complete = cut / JOURNAL_RECORD_SIZE;
+        for (int i = 0; i < 3; i++) {
+            const State& expected = i < complete ? second : first;
+            CHECK_EQ(loaded.values[i], expected.values[i]);
+            CHECK_EQ(loaded.muted[i], expected.muted[i]);
+            CHECK_EQ(loaded.previousValues[i], expected.previousValues[i]);
+        }
+    }
+}
+
+// Volume changes through the control loop, each save cut short at a different
+// byte. Once writes work again, the change that failed must still reach flash.
+TEST(controlLoopRecoversFromACutAtEveryByte) {
+    memoryFs.clear();
+    simBoot();
+    simRun(2000);
+    const long recordSize = JOURNAL_RECORD_SIZE;
+
+    for (long cut = 0; cut < recordSize; cut++) {
+        State saved(0);
+        CHECK(loadState(saved, sliders.layout));
+        int savedValue = saved.values[0];
+
+        memoryFs.setWriteBudget(cut);
+        simTurn(1, cut % 2 ? -1 : 1, 200000);  // Down from 100 and back
+        simRun(2000);
+        CHECK(memoryFs.budgetSpent());
+
+        State torn(0);
+        CHECK(loadState(torn, sliders.layout));
+        CHECK_EQ(torn.values[0], savedValue);
+
+        memoryFs.setWriteBudget(-1);
+        simRun(3000);
+        State recovered(0);
+        CHECK(loadState(recovered, sliders.layout));
+        CHECK_EQ(recovered.values[0], sliders.values[0]);
+        CHECK(recovered.values[0] != savedValue);
+    }
+}
@@ -0,0 +1,145 @@
+// The quadrature decoder fed pin states edge by edge, with contact bounce:
+// chatter between the old and new level before each edge settles.
+
+#include "Check.h"
+#include "QuadratureDecoder.h"
+
+// Pin states (bit 0 CLK, bit 1 DT) a clockwise turn walks through; DT leads.
+// Half-cycle encoders rest at 11 and 00, full-cycle ones only at 11.
+static const uint8_t CLOCKWISE[4] = {3, 1, 0, 2};
+
+struct Result {
+    int clockwise = 0;
+    int counterClockwise = 0;
+};
+
+static void feed(QuadratureDecoder& decoder, uint8_t pinState, Result& result) {
+    int8_t step = updateQuadratureDecoder(decoder, pinState);
+    if (step > 0) result.clockwise++;
+    if (step < 0) result.counterClockwise++;
+}
+
+// Moves one pin to its next level, chattering back and forth bounces times first
+static void edge(QuadratureDecoder& decoder, uint8_t from, uint8_t to, int bounces, Result& result) {
+    for (int i = 0; i < bounces; i++) {
+        feed(decoder, to, result);
+        feed(decoder, from, result);
+    }
+    feed(decoder, to, result);
+}
+
+// Turns edges quadrature edges from the decoder's current state, each with bounces(i) bounces
+template <typename Bounces>
+static Result turn(QuadratureDecoder& decoder, int edges, Bounces bounces) {
+    Result result;
+    int position = 0;
+    while (CLOCKWISE[position] != decoder.pinState) position++;
+    for (int i = 0; i < (edges < 0 ? -edges : edges); i++) {
+        int next = (position + (edges > 0 ? 1 : 3)) % 4;
+        edge(decoder, CLOCKWISE[position], CLOCKWISE[next], bounces(i), result);
+        position = next;
+    }
+    return result;
+}
+
+static QuadratureDecoder decoder(uint8_t countsPerDetent, bool reversed = false, bool rejectGlitches = true) {
+    QuadratureDecoder d;
+    initQuadratureDecoder(d, QuadratureConfig{countsPerDetent, reversed, rejectGlitches}, 3);
+    return d;
+}
+
+static int noBounce(int) { return 0; }
+
+TEST(cleanTurnsStepOncePerDetent) {
+    QuadratureDecoder d = decoder(2);
+    Result r = turn(d, 8, noBounce);
+    CHECK_EQ(r.clockwise, 4);
+    CHECK_EQ(r.counterClockwise, 0);
+    r = turn(d, -8, noBounce);
+    CHECK_EQ(r.clockwise, 0);
+    CHECK_EQ(r.counterClockwise, 4);
+    CHECK_EQ((int)d.count, 0);
+}
+
+TEST(bounceOnEveryEdgeCancelsOut) {
+    for (int bounces = 1; bounces <= 5; bounces++) {
+        QuadratureDecoder d = decoder(2);
+        Result r = turn(d, 10, [bounces](int) { return bounces; });
+        CHECK_EQ(r.clockwise, 5);
+        CHECK_EQ(r.counterClockwise, 0);
+        CHECK_EQ(d.glitches, (uint32_t)0);
+    }
+}
+
+TEST(irregularBounceCancelsOutBothWays) {
+    // Pseudo-random 0-7 bounces per edge, over many detents
+    uint32_t seed = 12345;
+    auto randomBounces = [&seed](int) {
+        seed = seed * 1103515245 + 12345;
+        return (int)((seed >> 16) & 7);
+    };
+    for (uint8_t counts : {2, 4}) {
+        QuadratureDecoder d = decoder(counts);
+        Result r = turn(d, 400, randomBounces);
+        CHECK_EQ(r.clockwise, 400 / counts);
+        CHECK_EQ(r.counterClockwise, 0);
+        r = turn(d, -400, randomBounces);
+        CHECK_EQ(r.clockwise, 0);
+        CHECK_EQ(r.counterClockwise, 400 / counts);
+    }
+}
+
+TEST(oneCountPerDetentFollowsBounceButNetsOut) {
+    // Every edge is a detent, so chatter steps back and forth; the net is still right
+    QuadratureDecoder d = decoder(1);
+    Result r = turn(d, 100, [](int i) { return i % 4; });
+    CHECK_EQ(r.clockwise - r.counterClockwise, 100);
+    CHECK(r.counterClockwise > 0);
+}
+
+TEST(bounceAtTheDetentEdgeStepsOnlyOnce) {
+    // The edge that completes the detent chatters: the step comes once, on the
+    // first arrival, and the reversals only move the count back and forth
+    QuadratureDecoder d = decoder(2);
+    Result r = turn(d, 1, noBounce);
+    r = turn(d, 1, [](int) { return 6; });
+    CHECK_EQ(r.clockwise, 1);
+    CHECK_EQ(r.counterClockwise, 0);
+}
+
+TEST(halfDetentAndBackGivesNoStep) {
+    QuadratureDecoder d = decoder(4);
+    Result r = turn(d, 3, [](int) { return 2; });
+    CHECK_EQ(r.clockwise + r.counterClockwise, 0);
+    r = turn(d, -3, [](int) { return 2; });
+    CHECK_EQ(r.clockwise + r.counterClockwise, 0);
+    CHECK_EQ((int)d.count, 0);
+}
+
+TEST(reversedSwapsDirection) {
+    QuadratureDecoder d = decoder(2, true);
+    Result r = turn(d, 6, [](int) { return 1; });
+    CHECK_EQ(r.clockwise, 0);
+    CHECK_EQ(r.counterClockwise, 3);
+}
+
+TEST(missedEdgeIsRejectedWhenConfigured) {
+    // 11 -> 00 in one read: both pins changed, direction unknown
+    QuadratureDecoder d = decoder(2);
+    Result r;
+    feed(d, 0, r);
+    CHECK_EQ(d.glitches, (uint32_t)1);
+    CHECK_EQ(r.clockwise + r.counterClockwise, 0);
+    // The next detent decodes normally from there
+    r = turn(d, 2, [](int) { return 3; });
+    CHECK_EQ(r.clockwise, 1);
+}
+
+TEST(missedEdgeFollowsTheTurnWhenNotRejected) {
+    QuadratureDecoder d = decoder(4, false, false);
+    Result r = turn(d, 1, noBounce);
+    feed(d, 2, r);  // 01 -> 10 skips 00: two edges on, the way it was turning
+    CHECK_EQ(d.glitches, (uint32_t)1);
+    r = turn(d, 1, noBounce);
+    CHECK_EQ(r.clockwise, 1);
+}
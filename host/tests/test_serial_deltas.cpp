@@ -0,0 +1,102 @@
+// Binary delta frames: a frame that replaces an unsent one must still carry
+// that frame's sliders, and keyframes must keep coming while deltas do.
+
+#include "Check.h"
+#include "DeejFrame.h"
+#include "DeejSim.h"
+#include "FakeSerial.h"
+#include "SerialTx.h"
+#include "SliderPool.h"
+#include "SliderProtocol.h"
+
+extern SliderPool sliders;
+
+// What the host has after applying every frame it received
+struct HostView {
+    uint16_t values[SLIDER_PACKET_MAX_SLIDERS] = {0};
+    int frames = 0;
+    int keyframes = 0;
+    int badFrames = 0;
+    int logLines = 0;
+    int sequenceGaps = 0;
+    int expectedSequence = -1;
+};
+
+static void receive(HostView& view) {
+    static std::vector<uint8_t> frame;
+    static SliderPacket packet;
+    for (const SerialByte& byte : fakeSerial.takeOutput()) {
+        if (byte.value != 0x00) {
+            frame.push_back(byte.value);
+            continue;
+        }
+        bool text = frame.size() >= 2 && frame[frame.size() - 2] == '\r' && frame.back() == '\n';
+        if (!decodeSliderPacket(frame.data(), frame.size(), packet)) {
+            if (text) view.logLines++;
+            else view.badFrames++;
+        } else {
+            view.frames++;
+            if (view.expectedSequence >= 0 && packet.sequence != view.expectedSequence) view.sequenceGaps++;
+            view.expectedSequence = (packet.sequence + 1) & 0xFF;
+            int included = 0;
+            for (int i = 0; i < packet.count; i++) {
+                if (packet.mask[i / 8] & (1 << (i % 8))) {
+                    view.values[i] = packet.values[i];
+                    included++;
+                }
+            }
+            if (included == packet.count) view.keyframes++;
+        }
+        frame.clear();
+    }
+}
+
+TEST(replacedDeltaKeepsItsSliders) {
+    // One byte of FIFO at 9600 baud: every frame takes about 10 ms to go out
+    fakeSerial.configure(9600, 1);
+    simBoot();
+    simRun(1100);  // Past the boot messages and the second keyframe
+    HostView view;
+    receive(view);
+    CHECK(view.logLines > 0);  // Boot messages, each between frames
+    CHECK_EQ(view.badFrames, 0);
+
+    // Master goes out, Master again waits behind it, then System replaces
+    // that waiting frame. All before the next keyframe is due.
+    unsigned long dropsBefore = serialTxFramesDropped;
+    simTurn(1, 1, 1000);
+    simRun(2);
+    simTurn(1, 1, 1000);
+    simRun(2);
+    simTurn(2, 1, 1000);
+    simRun(2);
+    simTurn(1, 1, 1000);
+    simRun(200);
+    receive(view);
+
+    CHECK(serialTxFramesDropped > dropsBefore);
+    CHECK_EQ(view.badFrames, 0);
+    CHECK_EQ(view.sequenceGaps, 0);
+    CHECK(sliders.values[0] != 100);
+    CHECK(sliders.values[1] != 100);
+    for (int i = 0; i < sliders.count; i++) {
+        CHECK_EQ(view.values[i], deejValue(sliders.values[i]));
+    }
+}
+
+TEST(keyframesKeepComingDuringDeltas) {
+    fakeSerial.configure(115200, 128);
+    simRun(1100);
+    HostView view;
+    receive(view);
+
+    // A delta every 100 ms for 3 s, so one is always more recent than a keyframe
+    for (int i = 0; i < 30; i++) {
+        simTurn(1, i % 2 ? 1 : -1, 100000);
+    }
+    simRun(3000);
+    receive(view);
+
+    CHECK(view.frames >= 30);
+    CHECK(view.keyframes >= 2);
+}
@@ -0,0 +1,103 @@
+// sliders_config.json parsing and validation, on files in the in-memory FS.
+
+#include "Check.h"
+#include "DeejControl.h"
+#include "MemoryFs.h"
+#include "SliderConfig.h"
+
+#include <string>
+
+static std::string check(const std::string& json) {
+    memoryFs.setFile("/test.json", json);
+    HalFile file = memoryFs.open("/test.json", "r");
+    const char* error = checkSliderConfig(file);
+    return error ? error : "ok";
+}
+
+static std::string manySliders(int count) {
+    std::string json = "{\"num_sliders\": " + std::to_string(count) + ", \"sliders\": [";
+    for (int i = 0; i < count; i++) json += std::string(i ? "," : "") + "{\"name\": \"S" + std::to_string(i) + "\"}";
+    return json + "]}";
+}
+
+static const std::string TWO_SLIDERS =
+    "{\"num_sliders\": 2, \"sliders\": [{\"name\": \"A\", \"value\": 10}, {\"name\": \"B\"}]}";
+
+TEST(acceptsWellFormedConfig) {
+    CHECK_EQ(check(TWO_SLIDERS), std::string("ok"));
+    CHECK_EQ(check("\r\n{ \"num_sliders\" : 1 ,\r\n \"sliders\" : [ { } ] ,"
+                   " \"acceleration\" : [ {\"interval_ms\": 10, \"step\": 5} ], \"x\": {\"y\": [1, null]} }\r\n"),
+             std::string("ok"));
+}
+
+TEST(requiresCommas) {
+    CHECK_EQ(check("{\"num_sliders\": 2 \"sliders\": []}"), std::string("Expected ',' between values"));
+    CHECK_EQ(check("{\"num_sliders\": 2, \"sliders\": [{\"name\": \"A\"} {\"name\": \"B\"}]}"),
+             std::string("Expected ',' between values"));
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{\"name\": \"A\" \"value\": 1}]}"),
+             std::string("Expected ',' between values"));
+}
+
+TEST(requiresColons) {
+    CHECK_EQ(check("{\"num_sliders\" 1, \"sliders\": [{}]}"), std::string("Expected ':' after a key"));
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{\"name\", \"A\"}]}"), std::string("Expected ':' after a key"));
+}
+
+TEST(rejectsMisplacedSeparators) {
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{},]}"), std::string("Trailing ','"));
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{}],}"), std::string("Trailing ','"));
+    CHECK_EQ(check("{,\"num_sliders\": 1}"), std::string("Unexpected character"));
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [:{}]}"), std::string("Unexpected character"));
+    CHECK_EQ(check("{\"num_sliders\":: 1}"), std::string("Unexpected character"));
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{\"name\": \"A\": 1}]}"),
+             std::string("Expected ',' between values"));
+    CHECK_EQ(check("{\"num_sliders\": 1, 2: 3}"), std::string("Expected a key"));
+}
+
+TEST(rejectsBadNesting) {
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{}}"), std::string("Unexpected closing bracket"));
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{}]} {}"), std::string("Unexpected data after the config"));
+    CHECK_EQ(check("{\"x\": " + std::string(40, '[') + std::string(40, ']') + "}"),
+             std::string("Config is nested too deeply"));
+}
+
+TEST(scanSizesThePoolAndReadsTheCurve) {
+    memoryFs.setFile("/test.json", "{\"num_sliders\": 2, \"sliders\": [{\"name\": \"Music\"}, {\"name\": \"Chat\"}],"
+                                   " \"acceleration\": [{\"interval_ms\": 50, \"step\": 4}, {\"interval_ms\": 10, \"step\": 0},"
+                                   " {\"interval_ms\": 5, \"step\": 20}]}");
+    HalFile file = memoryFs.open("/test.json", "r");
+    SliderConfigSummary summary;
+    CHECK(scanSliderConfig(file, 255, summary) == nullptr);
+    CHECK_EQ(summary.numSliders, 2);
+    CHECK_EQ(summary.nameBytes, (size_t)11);
+    CHECK_EQ(summary.numAccelerationPoints, 2);  // step 0 is left out
+    CHECK_EQ(summary.acceleration[1].step, 20);
+}
+
+TEST(appliesTheSliderLimit) {
+    memoryFs.setFile("/test.json", manySliders(256));
+    HalFile file = memoryFs.open("/test.json", "r");
+    SliderConfigSummary summary;
+    CHECK_EQ(std::string(scanSliderConfig(file, 255, summary)), std::string("Too many sliders for the serial protocol"));
+    CHECK_EQ(check(manySliders(256)), std::string("ok"));  // The host build sends text frames
+}
+
+TEST(rejectsInconsistentConfigs) {
+    CHECK_EQ(check("{\"num_sliders\": 0, \"sliders\": []}"), std::string("num_sliders must be at least 1"));
+    CHECK_EQ(check("{\"num_sliders\": 3, \"sliders\": [{}, {}]}"),
+             std::string("num_sliders does not match the sliders array"));
+    CHECK_EQ(check("{\"num_sliders\": 1, \"sliders\": [{\"value\": 101}]}"),
+             std::string("Slider values must be between 0 and 100"));
+}
+
+TEST(emptyPoolNeverRunsTheControlPass) {
+    memoryFs.setFile(SLIDER_CONFIG_PATH, "{\"num_sliders\": 2, \"sliders\": [{}]}");
+    initDeejControl();
+    CHECK(inWifiSetupMode);
+
+    // Leaving setup mode with the config still unusable goes straight back
+    inWifiSetupMode = false;
+    requestConfigReload();
+    runDeejControl();
+    CHECK(inWifiSetupMode);
+}
@@ -0,0 +1,88 @@
+// Snapshots and journal records are only applied to the slider layout they
+// were written for.
+
+#include "Check.h"
+#include "MemoryFs.h"
+#include "SliderJournal.h"
+#include "SliderState.h"
+
+static const char* const OLD_NAMES[] = {"Master", "System", "Mic"};
+static const char* const NEW_NAMES[] = {"Mic", "Master"};
+
+struct State {
+    int values[3] = {50, 50, 50};
+    bool muted[3] = {false, false, false};
+    int previousValues[3] = {50, 50, 50};
+};
+
+TEST(layoutIdDependsOnNamesAndOrder) {
+    const char* const swapped[] = {"System", "Master", "Mic"};
+    const char* const split[] = {"Mast", "erSystem", "Mic"};
+    uint32_t id = sliderLayoutId(OLD_NAMES, 3);
+    CHECK_EQ(id, sliderLayoutId(OLD_NAMES, 3));
+    CHECK(id != sliderLayoutId(swapped, 3));
+    CHECK(id != sliderLayoutId(split, 3));
+    CHECK(id != sliderLayoutId(OLD_NAMES, 2));
+}
+
+TEST(snapshotLoadsOnlyForItsLayout) {
+    memoryFs.clear();
+    uint32_t oldLayout = sliderLayoutId(OLD_NAMES, 3);
+    uint32_t newLayout = sliderLayoutId(NEW_NAMES, 2);
+
+    State saved;
+    saved.values[0] = 10;
+    saved.values[1] = 20;
+    CHECK(saveSliderState(saved.values, saved.muted, saved.previousValues, 3, oldLayout));
+
+    State loaded;
+    CHECK(!loadSliderState(loaded.values, loaded.muted, loaded.previousValues, 2, newLayout));
+    CHECK_EQ(loaded.values[0], 50);
+    CHECK(loadSliderState(loaded.values, loaded.muted, loaded.previousValues, 3, oldLayout));
+    CHECK_EQ(loaded.values[1], 20);
+}
+
+TEST(newerSnapshotOfAnotherLayoutIsSkipped) {
+    memoryFs.clear();
+    uint32_t oldLayout = sliderLayoutId(OLD_NAMES, 3);
+    uint32_t newLayout = sliderLayoutId(NEW_NAMES, 2);
+
+    State old;
+    old.values[2] = 30;
+    CHECK(saveSliderState(old.values, old.muted, old.previousValues, 3, oldLayout));
+    State newer;
+    newer.values[0] = 70;
+    CHECK(saveSliderState(newer.values, newer.muted, newer.previousValues, 2, newLayout));
+
+    State loaded;
+    CHECK(loadSliderState(loaded.values, loaded.muted, loaded.previousValues, 3, oldLayout));
+    CHECK_EQ(loaded.values[2], 30);
+    CHECK(loadSliderState(loaded.values, loaded.muted, loaded.previousValues, 2, newLayout));
+    CHECK_EQ(loaded.values[0], 70);
+}
+
+TEST(journalReplaysOnlyItsLayout) {
+    memoryFs.clear();
+    uint32_t oldLayout = sliderLayoutId(OLD_NAMES, 3);
+    uint32_t newLayout = sliderLayoutId(NEW_NAMES, 2);
+
+    bool changed[3] = {true, false, false};
+    State old;
+    old.values[0] = 5;
+    CHECK(appendJournal(changed, old.values, old.muted, old.previousValues, 3, oldLayout));
+    State newer;
+    newer.values[0] = 95;
+    newer.muted[0] = true;
+    CHECK(appendJournal(changed, newer.values, newer.muted, newer.previousValues, 2, newLayout));
+    CHECK_EQ(journalSize(), 2 * JOURNAL_RECORD_SIZE);
+
+    // The old record comes first but doesn't stop the replay
+    State loaded;
+    CHECK_EQ(replayJournal(loaded.values, loaded.muted, loaded.previousValues, 2, newLayout), 1);
+    CHECK_EQ(loaded.values[0], 95);
+    CHECK(loaded.muted[0]);
+
+    State other;
+    CHECK_EQ(replayJournal(other.values, other.muted, other.previousValues, 3, oldLayout), 1);
+    CHECK_EQ(other.values[0], 5);
+}
@@ -0,0 +1,40 @@
+#include "Acceleration.h"
+
+uint8_t accelerationTable[ACCELERATION_TABLE_SIZE];
+
+void buildAccelerationTable(const AccelerationPoint* points, int count, uint8_t defaultStep) {
+    for (int ms = 0; ms < ACCELERATION_TABLE_SIZE; ms++) {
+        if (count <= 0) {
+            accelerationTable[ms] = defaultStep;
+            continue;
+        }
+
+        // Closest points at or below and above this interval
+        const AccelerationPoint* below = nullptr;
+        const AccelerationPoint* above = nullptr;
+        for (int i = 0; i < count; i++) {
+            const AccelerationPoint& p = points[i];
+            if (p.intervalMs <= ms && (!below || p.intervalMs > below->intervalMs)) below = &p;
+            if (p.intervalMs > ms && (!above || p.intervalMs < above->intervalMs)) above = &p;
+        }
+
+        int step;
+        if (!below) {
+            step = above->step;
+        } else if (!above) {
+            step = below->step;
+        } else {
+            int span = above->intervalMs - below->intervalMs;
+            int offset = ms - below->intervalMs;
+            // Division truncates toward zero, so round half away from zero by hand
+            int change = (above->step - below->step) * offset;
+            step = below->step + (change < 0 ? change - span / 2 : change + span / 2) / span;
+        }
+        accelerationTable[ms] = step < 1 ? 1 : step;
+    }
+}
+
+uint8_t accelerationStep(uint32_t intervalMicros) {
+    uint32_t ms = intervalMicros / 1000;
+    return accelerationTable[ms < ACCELERATION_TABLE_SIZE ? ms : ACCELERATION_TABLE_SIZE - 1];
+}
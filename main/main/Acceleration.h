@@ -0,0 +1,26 @@
+#ifndef ACCELERATION_H
+#define ACCELERATION_H
+
+#include <stdint.h>
+
+// Volume encoder acceleration. The curve maps the time between two detents to
+// how many units (of 0-100) one detent moves the slider, and is precomputed
+// into a table at config load so the loop only does a lookup.
+
+struct AccelerationPoint {
+    uint16_t intervalMs;  // Time since the previous detent
+    uint8_t step;         // Units per detent at that speed
+};
+
+const int MAX_ACCELERATION_POINTS = 8;  // More points in a config are ignored
+
+// Table resolution: intervals of this many ms or more use the slowest point
+const int ACCELERATION_TABLE_SIZE = 256;
+
+// Interpolates linearly between points, in any order. With no points every
+// detent moves defaultStep units.
+void buildAccelerationTable(const AccelerationPoint* points, int count, uint8_t defaultStep);
+
+uint8_t accelerationStep(uint32_t intervalMicros);
+
+#endif
@@ -0,0 +1,68 @@
+#include "Buttons.h"
+
+void initButton(Button& button, const ButtonConfig& config) {
+    button.config = config;
+    button.down = false;
+    button.rawDown = false;
+    button.changedMs = 0;
+    button.releasedMs = 0;
+    button.clicks = 0;
+    button.longPressed = false;
+    button.clockMs = 0;
+    button.edges = 0;
+}
+
+void feedButtonEdge(Button& button, bool down, uint32_t timeMs) {
+    int slot = button.edges < BUTTON_EDGE_QUEUE ? button.edges++ : BUTTON_EDGE_QUEUE - 1;
+    button.edgeMs[slot] = timeMs;
+    button.edgeDown[slot] = down;
+}
+
+// Moves the button's clock to nowMs with the raw level unchanged
+void advanceButton(Button& button, uint8_t id, uint32_t nowMs, ButtonGestureHandler handler) {
+    // An edge stamped before the last update is taken as happening at that update
+    if ((int32_t)(nowMs - button.clockMs) < 0) nowMs = button.clockMs;
+    button.clockMs = nowMs;
+
+    // The first edge is taken right away; bounce after it is ignored until it settles
+    if (button.rawDown != button.down && nowMs - button.changedMs >= button.config.debounceMs) {
+        button.down = button.rawDown;
+        button.changedMs = nowMs;
+
+        if (button.down) {
+            button.longPressed = false;
+            handler(id, GESTURE_PRESS);
+        } else {
+            handler(id, GESTURE_RELEASE);
+            if (!button.longPressed) {
+                button.clicks++;
+                button.releasedMs = nowMs;
+                if (button.clicks == 2) {
+                    button.clicks = 0;
+                    handler(id, GESTURE_DOUBLE_CLICK);
+                }
+            }
+        }
+    }
+
+    if (button.down && !button.longPressed && nowMs - button.changedMs >= button.config.longPressMs) {
+        button.longPressed = true;
+        button.clicks = 0;
+        handler(id, GESTURE_LONG_PRESS);
+    }
+
+    if (!button.down && button.clicks == 1 && nowMs - button.releasedMs >= button.config.doubleClickMs) {
+        button.clicks = 0;
+        handler(id, GESTURE_CLICK);
+    }
+}
+
+void updateButton(Button& button, uint8_t id, uint32_t nowMs, ButtonGestureHandler handler) {
+    for (int i = 0; i < button.edges; i++) {
+        advanceButton(button, id, button.edgeMs[i], handler);  // Timeouts before the edge
+        button.rawDown = button.edgeDown[i];
+        advanceButton(button, id, button.edgeMs[i], handler);
+    }
+    button.edges = 0;
+    advanceButton(button, id, nowMs, handler);
+}
@@ -0,0 +1,53 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include <stdint.h>
+
+// Non-blocking button engine. Raw edges (from the ISR event queue) are
+// debounced by time and turned into gestures as the loop advances the clock;
+// nothing here ever waits. Edges keep the time they happened at, so a press
+// and release that arrive in the same loop pass are both seen.
+
+enum ButtonGesture : uint8_t {
+    GESTURE_PRESS,         // Debounced press, reported immediately
+    GESTURE_RELEASE,
+    GESTURE_CLICK,         // Press and release, once no second click followed in time
+    GESTURE_DOUBLE_CLICK,
+    GESTURE_LONG_PRESS     // Held for longPressMs; no click follows its release
+};
+
+struct ButtonConfig {
+    uint16_t debounceMs;     // Edges this soon after an accepted change are bounce
+    uint16_t doubleClickMs;  // Max time from a release to the next release for a double click
+    uint32_t longPressMs;
+};
+
+const int BUTTON_EDGE_QUEUE = 8;  // Raw edges held between two updateButton() calls
+
+struct Button {
+    ButtonConfig config;
+    bool down;         // Debounced state
+    bool rawDown;      // Last level seen on the pin
+    uint32_t changedMs;
+    uint32_t releasedMs;
+    uint8_t clicks;    // Clicks waiting to become CLICK or DOUBLE_CLICK
+    bool longPressed;
+    uint32_t clockMs;  // Time the button was last brought up to
+    uint8_t edges;     // Raw edges waiting for updateButton(), oldest first
+    uint32_t edgeMs[BUTTON_EDGE_QUEUE];
+    bool edgeDown[BUTTON_EDGE_QUEUE];
+};
+
+typedef void (*ButtonGestureHandler)(uint8_t button, ButtonGesture gesture);
+
+void initButton(Button& button, const ButtonConfig& config);
+
+// Records a raw pin edge at timeMs (on the halMillis() clock). When the queue
+// is full the newest edge replaces the last one, so the final level is kept.
+void feedButtonEdge(Button& button, bool down, uint32_t timeMs);
+
+// Applies the queued edges in order, then debounced changes and timeouts up
+// to nowMs, reporting each gesture to handler
+void updateButton(Button& button, uint8_t id, uint32_t nowMs, ButtonGestureHandler handler);
+
+#endif
@@ -1,299 +1,487 @@
 #include "DeejControl.h"
-
-// External encoders defined in main.cpp
-extern Encoder encoder1;
-extern Encoder encoder2;
-
-const int SCALE_FACTOR = 2;  // Adjust based on encoder resolution
+#include "DeejFrame.h"
+#include "SliderProtocol.h"
+#include "SerialTx.h"
+#include "DeejTrace.h"
+#include "LoopProfiler.h"
+#include "InputEvents.h"
+#include "Acceleration.h"
+#include "Buttons.h"
+#include "DisplayRenderer.h"
+#include "SliderLabels.h"
+#include "SliderJournal.h"
+#include "SliderState.h"
+#include "Persistence.h"
+#include "SliderPool.h"
+#include "SliderConfig.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+const int SCALE_FACTOR = 2;  // Units per detent when the config has no acceleration curve
 const int MAX_VALUE = 100;
 const int MIN_VALUE = 0;
 
-int numSliders = 0;
-int* sliderValues = nullptr;
-int* previousValues = nullptr;
-bool* mutedStates = nullptr;
-String* sliderNames = nullptr;
+SliderPool sliders;  // All per-slider state, rebuilt on every config load
 
 int currentSlider = 0;
-bool buttonPressed = false;
 
-// For long-press on second encoder
-unsigned long encoder2PressStart = 0;
-bool encoder2LongPressActive = false;
+// Input drained from the ISR queue each loop pass
+InputEvent inputEvents[INPUT_QUEUE_SIZE];
+long encoder1Units = 0;  // Volume change not yet applied, after acceleration
+long encoder2Steps = 0;  // Detents not yet applied
+uint32_t lastEncoder1StepMicros = 0;
+int8_t lastEncoder1Direction = 0;
+Button button1;  // Mute
+Button button2;  // Setup mode
+
+// Per-slider change bits, one bitset per consumer of slider state, set by updateSlider()
+enum DirtyConsumer {
+    DIRTY_SAVE,
+    DIRTY_SERIAL,
+    DIRTY_DISPLAY,
+    DIRTY_CONSUMERS
+};
+uint32_t* dirtyBits[DIRTY_CONSUMERS];
+uint8_t dirtyConsumers = 0;  // Bit per consumer that has any slider dirty
+int shownSlider = -1;        // Slider in the last published view
+char displayStatus[SLIDER_STATUS_LENGTH] = "";
+bool displayStatusChanged = false;
 
 unsigned long lastChangeTime = 0;
-unsigned long writeInterval = 10000;  // 10 seconds wait after last change
-bool dataDirty = false;
-int* lastSavedValues = nullptr;
-bool* lastSavedMuted = nullptr;
-int* lastSavedPreviousValues = nullptr;
-
-bool valuesAreDifferent() {
-    for (int i = 0; i < numSliders; i++) {
-        if (sliderValues[i] != lastSavedValues[i]) return true;
-        if (mutedStates[i] != lastSavedMuted[i]) return true;
-        if (previousValues[i] != lastSavedPreviousValues[i]) return true;
+unsigned long writeInterval = 500;  // Wait after last change before journalling it
+
+uint8_t packetSequence = 0;
+bool queuedKeyframe = false;  // Whether the binary frame waiting in SerialTx is a keyframe
+unsigned long lastKeyframeTime = 0;  // Deltas in between don't count
+bool keyframePending = true;  // Always send the first frame after boot
+unsigned long serialFramesSent = 0;
+unsigned long serialFramesSuppressed = 0;
+
+// The one way slider state changes after loading, so every consumer sees it
+void updateSlider(int slider, int value, bool muted, int previousValue) {
+    if (sliders.values[slider] == value && sliders.muted[slider] == muted && sliders.previousValues[slider] == previousValue) {
+        return;
+    }
+
+    sliders.values[slider] = value;
+    sliders.muted[slider] = muted;
+    sliders.previousValues[slider] = previousValue;
+
+    uint32_t bit = 1u << (slider % 32);
+    for (int c = 0; c < DIRTY_CONSUMERS; c++) {
+        dirtyBits[c][slider / 32] |= bit;
     }
-    return false;
+    dirtyConsumers = (1 << DIRTY_CONSUMERS) - 1;
+    lastChangeTime = halMillis();
+}
+
+bool anyDirty(DirtyConsumer consumer) {
+    return dirtyConsumers & (1 << consumer);
+}
+
+bool isDirty(DirtyConsumer consumer, int slider) {
+    return dirtyBits[consumer][slider / 32] & (1u << (slider % 32));
+}
+
+void clearDirty(DirtyConsumer consumer) {
+    if (!anyDirty(consumer)) return;
+    memset(dirtyBits[consumer], 0, dirtyWords(sliders) * sizeof(uint32_t));
+    dirtyConsumers &= ~(1 << consumer);
 }
 
-void markDataSaved() {
-    for (int i = 0; i < numSliders; i++) {
-        lastSavedValues[i] = sliderValues[i];
-        lastSavedMuted[i] = mutedStates[i];
-        lastSavedPreviousValues[i] = previousValues[i];
+void bindDirtyBits() {
+    for (int c = 0; c < DIRTY_CONSUMERS; c++) {
+        dirtyBits[c] = sliders.dirty + c * dirtyWords(sliders);
     }
-    dataDirty = false;
+    dirtyConsumers = 0;
 }
 
-bool loadSliderConfig() {
-    if (!SPIFFS.exists("/sliders_config.json")) {
-        Serial.println("No config found, creating default with 3 sliders.");
-        StaticJsonDocument<512> doc;
-        doc["num_sliders"] = 3;
-        JsonArray sliders = doc.createNestedArray("sliders");
-
-        const char* defaultNames[3] = {"Master", "System", "Mic"};
-        int defaultValues[3] = {100, 100, 100};
-
-        for (int i = 0; i < 3; i++) {
-            JsonObject s = sliders.createNestedObject();
-            s["name"] = defaultNames[i];
-            s["value"] = defaultValues[i];
-            s["muted"] = false;
-            s["previous_value"] = defaultValues[i];
-        }
+bool writeDefaultConfig() {
+    HalFile file = halFs().open(SLIDER_CONFIG_PATH, "w");
+    if (!file) {
+        return false;
+    }
 
-        File file = SPIFFS.open("/sliders_config.json", "w");
-        if (!file) {
-            Serial.println("Failed to create default sliders_config.json");
+    const char* defaultNames[3] = {"Master", "System", "Mic"};
+    SliderConfigWriter writer;
+    beginConfigWrite(writer, file, 3);
+    for (int i = 0; i < 3; i++) {
+        SliderConfigEntry entry;
+        strcpy(entry.name, defaultNames[i]);
+        entry.value = 100;
+        entry.muted = false;
+        entry.previousValue = 100;
+        writeConfigSlider(writer, entry);
+    }
+    endConfigWrite(writer);
+    DEEJ_TRACE_FS_WRITE(SLIDER_CONFIG_PATH, file.size());
+    file.close();
+    return true;
+}
+
+// Frames carry a slider count byte in the binary protocol
+int maxConfigSliders() {
+    return serialProtocol == SERIAL_PROTOCOL_BINARY ? SLIDER_PACKET_MAX_SLIDERS : INT_MAX;
+}
+
+const char* checkSliderConfig(HalStream& in) {
+    SliderConfigSummary summary;
+    return scanSliderConfig(in, maxConfigSliders(), summary);
+}
+
+bool loadSliderConfig() {
+    recoverSliderConfig();
+    if (!halFs().exists(SLIDER_CONFIG_PATH)) {
+        serialLog("No config found, creating default with 3 sliders.");
+        if (!writeDefaultConfig()) {
+            serialLog("Failed to create default sliders_config.json");
             return false;
         }
-        serializeJson(doc, file);
-        file.close();
     }
 
-    File file = SPIFFS.open("/sliders_config.json", "r");
+    HalFile file = halFs().open(SLIDER_CONFIG_PATH, "r");
     if (!file) {
-        Serial.println("Failed to open sliders_config.json");
+        serialLog("Failed to open sliders_config.json");
         return false;
     }
 
-    StaticJsonDocument<1024> doc;
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+    // The file is read twice, the first time to check it and size the slider pool
+    SliderConfigSummary summary;
+    const char* error = scanSliderConfig(file, maxConfigSliders(), summary);
     if (error) {
-        Serial.print("Failed to parse sliders_config.json: ");
-        Serial.println(error.f_str());
+        file.close();
+        serialLog("Invalid sliders_config.json: %s", error);
         return false;
     }
 
-    numSliders = doc["num_sliders"];
-    if (numSliders <= 0) {
-        Serial.println("Invalid number of sliders in config.");
+    int count = summary.numSliders;
+    size_t frameSize = serialProtocol == SERIAL_PROTOCOL_BINARY
+        ? sliderPacketBufferSize(count) : deejFrameBufferSize(count);
+    if (!initSliderPool(sliders, count, DIRTY_CONSUMERS, frameSize, summary.nameBytes)) {
+        file.close();
+        serialLog("Not enough memory for the sliders.");
         return false;
     }
-
-    sliderValues = new int[numSliders];
-    previousValues = new int[numSliders];
-    mutedStates = new bool[numSliders];
-    sliderNames = new String[numSliders];
-    lastSavedValues = new int[numSliders];
-    lastSavedMuted = new bool[numSliders];
-    lastSavedPreviousValues = new int[numSliders];
-
-    JsonArray sliders = doc["sliders"].as<JsonArray>();
-    for (int i = 0; i < numSliders; i++) {
-        JsonObject s = sliders[i];
-        sliderNames[i] = s["name"].as<String>();
-
-        int val = s["value"] | 50;
-        bool muted = s["muted"] | false;
-        int prevVal = s["previous_value"] | val;
-
-        sliderValues[i] = val;
-        previousValues[i] = prevVal;
-        mutedStates[i] = muted;
-
-        lastSavedValues[i] = val;
-        lastSavedMuted[i] = muted;
-        lastSavedPreviousValues[i] = prevVal;
+    bindDirtyBits();
+    currentSlider = 0;
+    shownSlider = -1;
+    initSerialTx(frameSize, serialProtocol == SERIAL_PROTOCOL_BINARY);
+    buildAccelerationTable(summary.acceleration, summary.numAccelerationPoints, SCALE_FACTOR);
+
+    // Already checked, so this pass can't fail
+    SliderConfigReader reader;
+    SliderConfigEntry entry;
+    SliderConfigSection section;
+    file.seek(0);
+    beginConfigRead(reader, file);
+    while ((section = nextConfigSection(reader)) > CONFIG_END) {
+        if (section != CONFIG_SLIDERS) continue;
+        for (int i = 0; nextConfigSlider(reader, entry) && i < sliders.count; i++) {
+            setSliderName(sliders, i, entry.name);
+            sliders.values[i] = entry.value;
+            sliders.previousValues[i] = entry.previousValue;
+            sliders.muted[i] = entry.muted;
+        }
     }
+    file.close();
 
-    Serial.println("Slider config loaded successfully.");
+    buildSliderLabels(sliders.names, sliders.count);
+    sliders.layout = sliderLayoutId(sliders.names, sliders.count);
+
+    serialLog("Slider config loaded successfully.");
+    serialLog("Slider pool: %u bytes for %d sliders, %u bytes heap free.",
+              (unsigned)sliders.bytes, sliders.count, (unsigned)halFreeHeap());
     return true;
 }
 
-void adjustSliderValues(bool& valueChanged) {
-    static long lastEncoder1Position = 0;  // Keep track of last hardware reading
-    long currentPosition = encoder1.read();
-
-    // Calculate the raw delta
-    long rawDelta = currentPosition - lastEncoder1Position;
-    
-    // Invert direction: either multiply by -1 or flip subtraction
-    rawDelta = -rawDelta; 
-
-    // Convert raw delta to "steps" if your encoder goes 2 ticks per step
-    int steps = rawDelta / 2;
-
-    // Only act if we got at least one step
-    if (steps != 0) {
-        // --- CRITICAL CHANGE ---
-        // Update lastEncoder1Position to the actual hardware reading
-        // so that next loop we measure from the correct baseline
-        lastEncoder1Position = currentPosition;
-
-        // Unmute if needed
-        if (mutedStates[currentSlider]) {
-            sliderValues[currentSlider] = previousValues[currentSlider];
-            mutedStates[currentSlider] = false;
-        }
+// Values in the config are only defaults for a device without saved state.
+// The state file holds the last snapshot, the journal everything since.
+void restoreSliderState() {
+    loadSliderState(sliders.values, sliders.muted, sliders.previousValues, sliders.count, sliders.layout);
+    int replayed = replayJournal(sliders.values, sliders.muted, sliders.previousValues, sliders.count, sliders.layout);
+    if (replayed > 0) {
+        serialLog("Replayed %d slider state changes.", replayed);
+    }
+}
+
+bool configReloadPending = false;
 
-        // Adjust slider value, respecting min/max
-        sliderValues[currentSlider] = constrain(
-            sliderValues[currentSlider] + steps * SCALE_FACTOR,
-            MIN_VALUE,
-            MAX_VALUE
-        );
+void requestConfigReload() {
+    configReloadPending = true;
+}
 
-        valueChanged = true;
+int findSlider(const SliderPool& pool, const char* name) {
+    for (int i = 0; i < pool.count; i++) {
+        if (strcmp(pool.names[i], name) == 0) return i;
     }
+    return -1;
 }
 
+// Rebuilds the sliders from the config file between two loop passes. Sliders
+// still in the config keep their state and the selection, matched by name.
+void reloadSliderConfig() {
+    configReloadPending = false;
+    unsigned long start = halMicros();
 
-void changeSliderSelection() {
-    static long lastEncoder2Position = 0;  // Track last encoder position
-    long currentPosition = encoder2.read();
+    SliderPool previous = sliders;
+    int previousSlider = currentSlider;
+    memset(&sliders, 0, sizeof(sliders));
+    if (!loadSliderConfig()) {
+        freeSliderPool(sliders);
+        sliders = previous;
+        currentSlider = previousSlider;
+        bindDirtyBits();
+        buildSliderLabels(sliders.names, sliders.count);
+        serialLog("Config reload failed, keeping the previous sliders.");
+        return;
+    }
 
-    int delta = currentPosition - lastEncoder2Position;
-    if (delta != 0) {
-        lastEncoder2Position = currentPosition;
-        currentSlider = (currentSlider + delta + numSliders) % numSliders;
+    for (int i = 0; i < previous.count; i++) {
+        int slider = findSlider(sliders, previous.names[i]);
+        if (slider < 0) continue;
+        sliders.values[slider] = previous.values[i];
+        sliders.muted[slider] = previous.muted[i];
+        sliders.previousValues[slider] = previous.previousValues[i];
+        if (i == previousSlider) currentSlider = slider;
     }
+    freeSliderPool(previous);
+
+    // Input for the old selection doesn't carry over
+    encoder1Units = 0;
+    encoder2Steps = 0;
+
+    restartPersistence(sliders.values, sliders.muted, sliders.previousValues, sliders.count, sliders.layout);
+    keyframePending = true;
+    serialLog("Config reloaded in %lu us.", (unsigned long)(halMicros() - start));
 }
 
-void handleMuteUnmute(bool& valueChanged) {
-    if (digitalRead(ENCODER1_SW) == LOW && !buttonPressed) {
-        delay(200);  // Simple debounce
-        if (mutedStates[currentSlider]) {
-            sliderValues[currentSlider] = previousValues[currentSlider];
-            mutedStates[currentSlider] = false;
-        } else {
-            previousValues[currentSlider] = sliderValues[currentSlider];
-            sliderValues[currentSlider] = 0;
-            mutedStates[currentSlider] = true;
+void readInputEvents() {
+    // Event times are halMicros(); buttons run on halMillis()
+    uint32_t nowMicros = halMicros();
+    uint32_t nowMs = halMillis();
+    size_t count = drainInputEvents(inputEvents, INPUT_QUEUE_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        const InputEvent& event = inputEvents[i];
+        switch (event.type) {
+            case INPUT_ENCODER_STEP:
+                if (event.encoder == 1) {
+                    // A change of direction starts again from the slowest step
+                    uint32_t interval = event.delta == lastEncoder1Direction
+                        ? event.timeMicros - lastEncoder1StepMicros : UINT32_MAX;
+                    encoder1Units += event.delta * accelerationStep(interval);
+                    lastEncoder1StepMicros = event.timeMicros;
+                    lastEncoder1Direction = event.delta;
+                } else {
+                    encoder2Steps += event.delta;
+                }
+                break;
+            case INPUT_BUTTON_DOWN:
+            case INPUT_BUTTON_UP:
+                feedButtonEdge(event.encoder == 1 ? button1 : button2, event.type == INPUT_BUTTON_DOWN,
+                               nowMs - (nowMicros - event.timeMicros) / 1000);
+                break;
         }
-        buttonPressed = true;
-        valueChanged = true;
-    } else if (digitalRead(ENCODER1_SW) == HIGH) {
-        buttonPressed = false;
     }
 }
 
-void updateDisplay() {
-    u8g2.clearBuffer();
-    u8g2.setFont(u8g2_font_ncenB08_tr);
-    u8g2.setCursor(0, 15);
-    u8g2.print(sliderNames[currentSlider] + " (" + String(currentSlider + 1) + "/" + String(numSliders) + ")");
-
-    int barWidth = map(sliderValues[currentSlider], 0, 100, 0, 105);
-    u8g2.drawFrame(0, 64 - 15 - 2, 105, 15);
-    u8g2.drawBox(0, 64 - 15 - 2, barWidth, 15);
-
-    if (mutedStates[currentSlider]) {
-        u8g2.setCursor(115, 59);
-        u8g2.print("M");
+void adjustSliderValues() {
+    int units = encoder1Units;
+
+    if (units != 0) {
+        encoder1Units = 0;
+
+        // Unmute if needed, then adjust, respecting min/max
+        int value = sliders.muted[currentSlider] ? sliders.previousValues[currentSlider] : sliders.values[currentSlider];
+        value += units;
+        if (value < MIN_VALUE) value = MIN_VALUE;
+        if (value > MAX_VALUE) value = MAX_VALUE;
+        updateSlider(currentSlider, value, false, sliders.previousValues[currentSlider]);
+    }
+}
+
+void changeSliderSelection() {
+    if (encoder2Steps != 0) {
+        currentSlider = ((currentSlider + encoder2Steps) % sliders.count + sliders.count) % sliders.count;
+        encoder2Steps = 0;
+    }
+}
+
+void toggleMute() {
+    if (sliders.muted[currentSlider]) {
+        updateSlider(currentSlider, sliders.previousValues[currentSlider], false, sliders.previousValues[currentSlider]);
     } else {
-        u8g2.setCursor(110, 59);
-        u8g2.print(String(sliderValues[currentSlider]));
+        updateSlider(currentSlider, 0, true, sliders.values[currentSlider]);
     }
+}
 
-    u8g2.sendBuffer();
+void enterSetupMode() {
+    serialLog("Long press detected. Entering WiFi setup mode.");
+    startWifiSetupMode();
+}
 
-    String builtString;
-    for (int i = 0; i < numSliders; i++) {
-        int mappedVal = map(sliderValues[i], 0, 100, 0, 1023);
-        builtString += String(mappedVal);
-        if (i < numSliders - 1)
-            builtString += "|";
+struct GestureBinding {
+    uint8_t button;
+    ButtonGesture gesture;
+    void (*action)();
+};
+
+const GestureBinding gestureBindings[] = {
+    {1, GESTURE_PRESS, toggleMute},
+    {2, GESTURE_LONG_PRESS, enterSetupMode},
+};
+
+void dispatchGesture(uint8_t button, ButtonGesture gesture) {
+    for (const GestureBinding& binding : gestureBindings) {
+        if (binding.button == button && binding.gesture == gesture) {
+            binding.action();
+        }
     }
-    Serial.println(builtString);
 }
 
-void handleSaving(bool valueChanged) {
-    if (valueChanged) {
-        dataDirty = true;
-        lastChangeTime = millis();
+void handleButtons() {
+    unsigned long now = halMillis();
+    updateButton(button1, 1, now, dispatchGesture);
+    updateButton(button2, 2, now, dispatchGesture);
+}
+
+void setDisplayStatus(const char* text) {
+    if (strncmp(displayStatus, text, SLIDER_STATUS_LENGTH - 1) == 0) return;
+    snprintf(displayStatus, sizeof(displayStatus), "%s", text);
+    displayStatusChanged = true;
+}
+
+void updateDisplay() {
+    bool changed = isDirty(DIRTY_DISPLAY, currentSlider) || currentSlider != shownSlider || displayStatusChanged;
+    clearDirty(DIRTY_DISPLAY);
+    displayStatusChanged = false;
+    if (!changed && displayIsValid()) {
+        return;
     }
 
-    if (dataDirty && (millis() - lastChangeTime > writeInterval)) {
-        if (valuesAreDifferent()) {
-            File file = SPIFFS.open("/sliders_config.json", "w");
-            StaticJsonDocument<1024> doc;
-            doc["num_sliders"] = numSliders;
-            JsonArray sliders = doc.createNestedArray("sliders");
-
-            for (int i = 0; i < numSliders; i++) {
-                JsonObject s = sliders.createNestedObject();
-                s["name"] = sliderNames[i];
-                s["value"] = sliderValues[i];
-                s["muted"] = mutedStates[i];
-                s["previous_value"] = previousValues[i];
-            }
-
-            serializeJson(doc, file);
-            file.close();
-            markDataSaved();
-            Serial.println("Saved after 10s of inactivity.");
-        } else {
-            dataDirty = false;
+    SliderView view;
+    view.slider = currentSlider;
+    view.numSliders = sliders.count;
+    view.value = sliders.values[currentSlider];
+    view.muted = sliders.muted[currentSlider];
+    memcpy(view.header, sliderLabel(currentSlider).text, SLIDER_LABEL_LENGTH);
+    memcpy(view.status, displayStatus, SLIDER_STATUS_LENGTH);
+    publishSliderView(view);
+    shownSlider = currentSlider;
+}
+
+bool keyframeDue() {
+    return halMillis() - lastKeyframeTime >= keyframeInterval;
+}
+
+// Keyframes carry every slider, other packets only the ones that changed.
+// A frame still waiting in SerialTx is replaced by this one, so this one also
+// carries that frame's sliders, under its sequence number.
+size_t encodeBinaryFrame() {
+    bool replacing = serialTxPending();
+    bool keyframe = keyframePending || keyframeDue() || (replacing && queuedKeyframe);
+    int maskBytes = (sliders.count + 7) / 8;
+    if (!keyframe) {
+        for (int i = 0; i < maskBytes; i++) {
+            sliders.mask[i] = dirtyBits[DIRTY_SERIAL][i / 4] >> (8 * (i % 4));
+            if (replacing) sliders.mask[i] |= sliders.queuedMask[i];
         }
+        memcpy(sliders.queuedMask, sliders.mask, maskBytes);
     }
+    queuedKeyframe = keyframe;
+    if (keyframe) lastKeyframeTime = halMillis();
+
+    uint8_t sequence = replacing ? packetSequence - 1 : packetSequence++;
+    return encodeSliderPacket((uint8_t*)sliders.frame, sliders.frameSize, sequence,
+                              sliders.values, keyframe ? nullptr : sliders.mask, sliders.count);
 }
 
-void initDeejControl() {
-    if (!loadSliderConfig()) {
-        Serial.println("Failed to load slider config, and no default could be created.");
-        displayError("Config Error!", "Please upload config.");
-        delay(1000);
-        startWifiSetupMode();
+void sendSliderValues() {
+    if (serialOutputMode == SERIAL_OUTPUT_ON_CHANGE) {
+        if (!anyDirty(DIRTY_SERIAL) && !keyframeDue() && !keyframePending) {
+            serialFramesSuppressed++;
+            return;
+        }
     }
 
-    pinMode(ENCODER1_SW, INPUT_PULLUP);
-    pinMode(ENCODER2_SW, INPUT_PULLUP);
+    size_t frameLength;
+    if (serialProtocol == SERIAL_PROTOCOL_BINARY) {
+        frameLength = encodeBinaryFrame();
+    } else {
+        frameLength = encodeDeejFrame(sliders.frame, sliders.frameSize, sliders.values, sliders.count);
+        lastKeyframeTime = halMillis();  // Text frames always carry every slider
+    }
+    queueSerialFrame((const uint8_t*)sliders.frame, frameLength);
+    clearDirty(DIRTY_SERIAL);
 
-    Serial.println("Deej Control Initialized");
+    keyframePending = false;
+    serialFramesSent++;
 }
 
-void checkLongPress() {
-    if (digitalRead(ENCODER2_SW) == LOW && !encoder2LongPressActive) {
-        encoder2PressStart = millis();
-        encoder2LongPressActive = true;
-    } else if (digitalRead(ENCODER2_SW) == HIGH && encoder2LongPressActive) {
-        encoder2LongPressActive = false;
+void handleSaving() {
+    if (anyDirty(DIRTY_SAVE) && halMillis() - lastChangeTime > writeInterval) {
+        // Written by the persistence task, off the input path
+        requestStateSave(dirtyBits[DIRTY_SAVE], sliders.values, sliders.muted, sliders.previousValues);
+        clearDirty(DIRTY_SAVE);
     }
+}
 
-    if (encoder2LongPressActive && (millis() - encoder2PressStart > 10000)) {
-        encoder2LongPressActive = false;
-        Serial.println("Long press detected. Entering WiFi setup mode.");
+void initDeejControl() {
+    initSerialLog();
+    if (loadSliderConfig()) {
+        restoreSliderState();
+    } else {
+        serialLog("Failed to load slider config, and no default could be created.");
+        displayError("Config Error!", "Please upload config.");
+        halDelay(1000);
         startWifiSetupMode();
     }
+
+    initButton(button1, button1Config);
+    initButton(button2, button2Config);
+    initInputEvents();
+    startDisplayTask();
+    startPersistenceTask(sliders.values, sliders.muted, sliders.previousValues, sliders.count, sliders.layout);
+
+    serialLog("Deej Control Initialized");
 }
 
+void runDeejControlPass();
+
 void runDeejControl() {
     if (inWifiSetupMode) {
         return;
     }
 
-    bool valueChanged = false;
-
-    adjustSliderValues(valueChanged);
-    changeSliderSelection();
-    handleMuteUnmute(valueChanged);
-    updateDisplay();
-    handleSaving(valueChanged);
-    checkLongPress();
+    if (configReloadPending) {
+        reloadSliderConfig();
+    }
+    if (sliders.count == 0) {
+        // No config has loaded yet, so there is nothing to control until one is uploaded
+        serialLog("No sliders loaded. Entering WiFi setup mode.");
+        startWifiSetupMode();
+        return;
+    }
+    PROFILE_PHASE(PHASE_LOOP, runDeejControlPass());
+}
 
-    delay(1);  // Smooth loop
+void runDeejControlPass() {
+#ifdef DEEJ_PROFILE
+    uint32_t passStart = halCycleCount() | 1;  // Never 0, which means "no input"
+#endif
+
+    PROFILE_PHASE(PHASE_SERIAL_TX, serviceSerialTx());
+    PROFILE_PHASE(PHASE_INPUT, readInputEvents());
+    PROFILE_PHASE(PHASE_ADJUST, adjustSliderValues());
+    PROFILE_PHASE(PHASE_SELECT, changeSliderSelection());
+    PROFILE_PHASE(PHASE_BUTTONS, handleButtons());
+    if (inWifiSetupMode) return;
+    PROFILE_PHASE(PHASE_DISPLAY, updateDisplay());
+#ifdef DEEJ_PROFILE
+    if (anyDirty(DIRTY_SERIAL)) markSerialInput(passStart);
+#endif
+    PROFILE_PHASE(PHASE_SERIAL, sendSliderValues());
+    PROFILE_PHASE(PHASE_SAVE, handleSaving());
+
+    halDelay(1);  // Smooth loop
 }
@@ -1,13 +1,9 @@
 #ifndef DEEJCONTROL_H
 #define DEEJCONTROL_H
 
-#include <Arduino.h>
-#include <SPIFFS.h>
-#include <U8g2lib.h>
-#include <ArduinoJson.h>
-#include <Encoder.h> // Include Encoder library
-
-extern U8G2_SH1106_128X64_NONAME_F_HW_I2C u8g2;
+#include "Hal.h"
+#include "QuadratureDecoder.h"
+#include "Buttons.h"
 
 extern const int ENCODER1_CLK;
 extern const int ENCODER1_DT;
@@ -17,8 +13,30 @@ extern const int ENCODER2_CLK;
 extern const int ENCODER2_DT;
 extern const int ENCODER2_SW;
 
-extern Encoder encoder1;
-extern Encoder encoder2;
+extern const QuadratureConfig encoder1Config;
+extern const QuadratureConfig encoder2Config;
+extern const ButtonConfig button1Config;
+extern const ButtonConfig button2Config;
+
+// How slider values are sent to deej over serial
+enum SerialOutputMode {
+    SERIAL_OUTPUT_EVERY_LOOP,  // A frame on every loop pass
+    SERIAL_OUTPUT_ON_CHANGE    // A frame when a value changes, plus periodic keyframes
+};
+
+// Wire format of serial frames
+enum SerialProtocol {
+    SERIAL_PROTOCOL_ASCII,   // deej's "a|b|c" text lines
+    SERIAL_PROTOCOL_BINARY   // COBS-framed, CRC-checked packets (see SliderProtocol.h)
+};
+
+extern const SerialOutputMode serialOutputMode;
+extern const SerialProtocol serialProtocol;
+extern const unsigned long keyframeInterval;
+
+// Serial output statistics
+extern unsigned long serialFramesSent;
+extern unsigned long serialFramesSuppressed;
 
 extern bool inWifiSetupMode;
 
@@ -28,4 +46,14 @@ extern void displayError(const char* line1, const char* line2);
 void initDeejControl();
 void runDeejControl();
 
+// Checks a config file the way loading it would. Returns null if it is valid,
+// otherwise why not.
+const char* checkSliderConfig(HalStream& in);
+
+// Reloads sliders_config.json before the next control loop pass
+void requestConfigReload();
+
+// Shows one line of status (WiFi) under the slider name, "" to remove it
+void setDisplayStatus(const char* text);
+
 #endif
@@ -0,0 +1,55 @@
+#include "DeejFrame.h"
+
+// map(value, 0, 100, 0, 1023) for every slider value
+static const uint16_t deejValueTable[101] = {
+       0,   10,   20,   30,   40,   51,   61,   71,   81,   92,
+     102,  112,  122,  132,  143,  153,  163,  173,  184,  194,
+     204,  214,  225,  235,  245,  255,  265,  276,  286,  296,
+     306,  317,  327,  337,  347,  358,  368,  378,  388,  398,
+     409,  419,  429,  439,  450,  460,  470,  480,  491,  501,
+     511,  521,  531,  542,  552,  562,  572,  583,  593,  603,
+     613,  624,  634,  644,  654,  664,  675,  685,  695,  705,
+     716,  726,  736,  746,  757,  767,  777,  787,  797,  808,
+     818,  828,  838,  849,  859,  869,  879,  890,  900,  910,
+     920,  930,  941,  951,  961,  971,  982,  992, 1002, 1012,
+    1023,
+};
+
+uint16_t deejValue(int value) {
+    if (value < 0) value = 0;
+    if (value > 100) value = 100;
+    return deejValueTable[value];
+}
+
+// Writes value (0-1023) as decimal text, returns the number of characters
+static size_t writeNumber(char* out, uint16_t value) {
+    char digits[4];
+    size_t len = 0;
+    do {
+        digits[len++] = '0' + (value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    for (size_t i = 0; i < len; i++) {
+        out[i] = digits[len - 1 - i];
+    }
+    return len;
+}
+
+size_t encodeDeejFrame(char* buf, size_t bufSize, const int* values, int count) {
+    if (count < 0 || bufSize < deejFrameBufferSize(count)) {
+        return 0;
+    }
+
+    char* out = buf;
+    for (int i = 0; i < count; i++) {
+        out += writeNumber(out, deejValue(values[i]));
+        if (i < count - 1)
+            *out++ = '|';
+    }
+    *out++ = '\r';
+    *out++ = '\n';
+    *out = '\0';
+
+    return out - buf;
+}
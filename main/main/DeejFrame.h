@@ -0,0 +1,23 @@
+#ifndef DEEJFRAME_H
+#define DEEJFRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest text for one slider is "1023|"
+const size_t DEEJ_FRAME_BYTES_PER_SLIDER = 5;
+
+// Buffer size for a frame of numSliders values, including "\r\n" and the terminator
+inline size_t deejFrameBufferSize(int numSliders) {
+    return numSliders * DEEJ_FRAME_BYTES_PER_SLIDER + 3;
+}
+
+// Slider value (0-100) to deej value (0-1023), same result as map(value, 0, 100, 0, 1023)
+uint16_t deejValue(int value);
+
+// Writes "a|b|c\r\n" for the given 0-100 slider values into buf, null-terminated.
+// The output matches Serial.println() of the old String-built line byte for byte.
+// Returns the frame length without the terminator, or 0 if buf is too small.
+size_t encodeDeejFrame(char* buf, size_t bufSize, const int* values, int count);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef DEEJTRACE_H
+#define DEEJTRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Output trace hooks. Build with DEEJ_TRACE defined and link an implementation
+// of the trace* functions to record every serial frame, display frame and
+// filesystem write with its timestamp, e.g. to compare a scripted run against
+// a recorded one (host/sim does this). Without DEEJ_TRACE the hooks compile
+// to nothing.
+//
+// A serial frame is traced once SerialTx has handed its last byte to the
+// driver, or when a newer frame replaced it before it started sending. A log
+// line is traced once all of it is out.
+
+#ifdef DEEJ_TRACE
+
+void traceSerialFrame(unsigned long timeMicros, const uint8_t* data, size_t length);
+void traceSerialDrop(unsigned long timeMicros, const uint8_t* data, size_t length);
+void traceSerialLog(unsigned long timeMicros, const char* line, size_t length);
+void traceDisplayFrame(unsigned long timeMicros, const uint8_t* buffer, size_t length);
+void traceFsWrite(unsigned long timeMicros, const char* path, size_t length);
+
+#define DEEJ_TRACE_SERIAL(data, length) traceSerialFrame(halMicros(), (data), (length))
+#define DEEJ_TRACE_SERIAL_DROP(data, length) traceSerialDrop(halMicros(), (data), (length))
+#define DEEJ_TRACE_SERIAL_LOG(line, length) traceSerialLog(halMicros(), (line), (length))
+#define DEEJ_TRACE_DISPLAY(buffer, length) traceDisplayFrame(halMicros(), (buffer), (length))
+#define DEEJ_TRACE_FS_WRITE(path, length) traceFsWrite(halMicros(), (path), (length))
+
+#else
+
+#define DEEJ_TRACE_SERIAL(data, length) do {} while (0)
+#define DEEJ_TRACE_SERIAL_DROP(data, length) do {} while (0)
+#define DEEJ_TRACE_SERIAL_LOG(line, length) do {} while (0)
+#define DEEJ_TRACE_DISPLAY(buffer, length) do {} while (0)
+#define DEEJ_TRACE_FS_WRITE(path, length) do {} while (0)
+
+#endif
+
+#endif
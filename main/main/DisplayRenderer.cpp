@@ -0,0 +1,157 @@
+#include "DisplayRenderer.h"
+#include "DeejTrace.h"
+#include <atomic>
+#include <string.h>
+
+// Latest view, guarded by a sequence lock: odd while the loop is writing it
+SliderView publishedView;
+std::atomic<uint32_t> viewSequence(0);
+std::atomic<bool> displayValid(false);  // Panel and shadow hold the last rendered view
+
+HalMutex displayMutex = nullptr;
+uint8_t* shadowBuffer = nullptr;  // Copy of what was last sent to the panel
+uint32_t renderedSequence = 0;
+
+unsigned long displayFramesRendered = 0;
+unsigned long displayBytesSent = 0;
+
+void lockDisplay() {
+    if (displayMutex) halLockMutex(displayMutex);
+}
+
+void unlockDisplay() {
+    if (displayMutex) halUnlockMutex(displayMutex);
+}
+
+void invalidateDisplay() {
+    displayValid = false;
+}
+
+bool displayIsValid() {
+    return displayValid;
+}
+
+static bool sameView(const SliderView& a, const SliderView& b) {
+    return a.slider == b.slider && a.numSliders == b.numSliders && a.value == b.value
+        && a.muted == b.muted && strcmp(a.header, b.header) == 0 && strcmp(a.status, b.status) == 0;
+}
+
+// Only the loop task writes, so the sequence can't change under it
+void publishSliderView(const SliderView& view) {
+    if (displayValid && sameView(view, publishedView)) {
+        return;
+    }
+
+    uint32_t sequence = viewSequence.load(std::memory_order_relaxed);
+    viewSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    publishedView = view;
+    viewSequence.store(sequence + 2, std::memory_order_release);
+}
+
+// Copies the latest view, retrying if the loop wrote it meanwhile
+static uint32_t readPublishedView(SliderView& view) {
+    uint32_t before, after;
+    do {
+        before = viewSequence.load(std::memory_order_acquire);
+        view = publishedView;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = viewSequence.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1));
+    return before;
+}
+
+static void drawSliderView(const SliderView& view) {
+    HalDisplay& display = halDisplay();
+    display.clearBuffer();
+    display.setFont(HAL_FONT_NORMAL);
+    display.drawStr(0, 15, view.header);
+
+    int barWidth = view.value * 105 / 100;
+    display.drawFrame(0, 64 - 15 - 2, 105, 15);
+    display.drawBox(0, 64 - 15 - 2, barWidth, 15);
+
+    if (view.muted) {
+        display.drawStr(115, 59, "M");
+    } else {
+        display.drawStr(110, 59, valueLabel(view.value));
+    }
+
+    if (view.status[0]) {
+        display.setFont(HAL_FONT_SMALL);
+        display.drawStr(0, 32, view.status);
+    }
+}
+
+// Sends each run of changed tiles per tile row, or everything if the shadow is stale
+static void sendChangedTiles(bool full) {
+    HalDisplay& display = halDisplay();
+    uint8_t* buffer = display.getBufferPtr();
+    int tileWidth = display.getBufferTileWidth();
+    int tileHeight = display.getBufferTileHeight();
+    size_t bufferSize = 8 * tileWidth * tileHeight;
+
+    if (!shadowBuffer) {
+        shadowBuffer = new uint8_t[bufferSize];
+        full = true;
+    }
+
+    if (full) {
+        display.sendBuffer();
+        displayBytesSent += bufferSize;
+    } else {
+        for (int ty = 0; ty < tileHeight; ty++) {
+            int tx = 0;
+            while (tx < tileWidth) {
+                size_t offset = (ty * tileWidth + tx) * 8;
+                if (memcmp(buffer + offset, shadowBuffer + offset, 8) == 0) {
+                    tx++;
+                    continue;
+                }
+
+                int start = tx;
+                while (tx < tileWidth) {
+                    offset = (ty * tileWidth + tx) * 8;
+                    if (memcmp(buffer + offset, shadowBuffer + offset, 8) == 0) break;
+                    tx++;
+                }
+                display.updateDisplayArea(start, ty, tx - start, 1);
+                displayBytesSent += (tx - start) * 8;
+            }
+        }
+    }
+
+    memcpy(shadowBuffer, buffer, bufferSize);
+    DEEJ_TRACE_DISPLAY(buffer, bufferSize);
+}
+
+static void renderLatestView() {
+    if (viewSequence.load(std::memory_order_acquire) == renderedSequence) {
+        return;
+    }
+
+    SliderView view;
+    uint32_t sequence = readPublishedView(view);
+
+    lockDisplay();
+    bool full = !displayValid.exchange(true);
+    drawSliderView(view);
+    sendChangedTiles(full);
+    unlockDisplay();
+
+    renderedSequence = sequence;
+    displayFramesRendered++;
+}
+
+static unsigned long displayTask() {
+    renderLatestView();
+    return 1000 / displayMaxFps;
+}
+
+void startDisplayTask() {
+    if (displayMutex) {
+        return;
+    }
+    displayMutex = halCreateMutex();
+    halStartTask(displayTask, "display", 4096, HAL_TASK_PRIORITY_LOW);
+}
@@ -0,0 +1,41 @@
+#ifndef DISPLAYRENDERER_H
+#define DISPLAYRENDERER_H
+
+#include "Hal.h"
+#include "SliderLabels.h"
+
+const int SLIDER_STATUS_LENGTH = 32;
+
+// What the slider screen shows, copied out of the control loop's state
+struct SliderView {
+    int slider;
+    int numSliders;
+    int value;
+    bool muted;
+    char header[SLIDER_LABEL_LENGTH];  // Copied from the label cache
+    char status[SLIDER_STATUS_LENGTH]; // Small line under the header, "" for none
+};
+
+extern const unsigned int displayMaxFps;
+
+// Starts the render task. It draws the latest published view when it changes,
+// at most displayMaxFps times a second, and sends only the 8x8 tiles that
+// differ from what is already on the panel. It runs below the control loop's
+// priority, so a slow I2C transfer never holds up input or serial output.
+void startDisplayTask();
+
+// Hands a view to the render task. Cheap; call it every loop pass.
+void publishSliderView(const SliderView& view);
+
+// Anything else drawing on the display must hold the display lock, and call
+// invalidateDisplay() so the next slider frame is sent in full.
+void lockDisplay();
+void unlockDisplay();
+void invalidateDisplay();
+bool displayIsValid();
+
+// Display statistics
+extern unsigned long displayFramesRendered;
+extern unsigned long displayBytesSent;
+
+#endif
@@ -0,0 +1,60 @@
+#include "Hal.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// The parts of the HAL types that are the same on every platform
+
+size_t HalPrint::print(const char* text) {
+    return write((const uint8_t*)text, strlen(text));
+}
+
+size_t HalPrint::println(const char* text) {
+    size_t written = print(text);
+    return written + write((const uint8_t*)"\r\n", 2);
+}
+
+size_t HalPrint::printf(const char* format, ...) {
+    char buffer[128];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length < sizeof(buffer)) {
+        return write((const uint8_t*)buffer, length);
+    }
+
+    // Rare long lines
+    char* large = new char[length + 1];
+    va_start(args, format);
+    vsnprintf(large, length + 1, format, args);
+    va_end(args);
+    size_t written = write((const uint8_t*)large, length);
+    delete[] large;
+    return written;
+}
+
+size_t HalStream::read(uint8_t* data, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) break;
+        data[count++] = c;
+    }
+    return count;
+}
+
+int HalFile::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+void HalFile::close() {
+    if (impl) {
+        impl->close();
+        impl.reset();
+    }
+}
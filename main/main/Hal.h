@@ -0,0 +1,166 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+
+// Hardware access for the controller logic. DeejControl and WifiSetup reach
+// pins, time, the display, the filesystem and the serial port only
+// through these, so the logic can be linked against another implementation
+// (fakes, a virtual clock) instead of HalEsp32.cpp. Nothing here depends on
+// the Arduino headers; host/ builds the logic natively against fakes.
+
+// Code that runs in interrupt handlers, placed in IRAM on the device, and the
+// constant data it reads, kept in DRAM. Flash is unreadable while it is being
+// written, and an interrupt can come in then.
+#ifdef ARDUINO
+#include <esp_attr.h>
+#define HAL_IRAM IRAM_ATTR
+#define HAL_DRAM DRAM_ATTR
+#else
+#define HAL_IRAM
+#define HAL_DRAM
+#endif
+
+// Byte output, with the print helpers the controller uses
+class HalPrint {
+public:
+    virtual ~HalPrint() {}
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+
+    size_t write(uint8_t byte) { return write(&byte, 1); }
+    size_t print(const char* text);
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t println(const char* text = "");
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// Byte input; read() and peek() return -1 when nothing is left
+class HalStream : public HalPrint {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t read(uint8_t* data, size_t length);
+
+    size_t readBytes(char* data, size_t length) { return read((uint8_t*)data, length); }
+};
+
+class HalSerial : public HalStream {
+public:
+    virtual int availableForWrite() = 0;  // Bytes that fit without blocking
+};
+
+class HalFileImpl {
+public:
+    virtual ~HalFileImpl() {}
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+    virtual size_t read(uint8_t* data, size_t length) = 0;
+    virtual int peek() = 0;
+    virtual int available() = 0;
+    virtual bool seek(size_t position) = 0;
+    virtual size_t size() = 0;
+    virtual void close() = 0;
+};
+
+// Open file handle. Copies share the open file, like fs::File; an empty
+// handle (failed open) is false.
+class HalFile : public HalStream {
+public:
+    HalFile() {}
+    explicit HalFile(std::shared_ptr<HalFileImpl> impl) : impl(impl) {}
+
+    using HalPrint::write;
+    size_t write(const uint8_t* data, size_t length) override { return impl ? impl->write(data, length) : 0; }
+    int available() override { return impl ? impl->available() : 0; }
+    int read() override;
+    int peek() override { return impl ? impl->peek() : -1; }
+    size_t read(uint8_t* data, size_t length) override { return impl ? impl->read(data, length) : 0; }
+    bool seek(size_t position) { return impl && impl->seek(position); }
+    size_t size() { return impl ? impl->size() : 0; }
+    void close();
+
+    explicit operator bool() const { return impl != nullptr; }
+
+private:
+    std::shared_ptr<HalFileImpl> impl;
+};
+
+class HalFs {
+public:
+    virtual ~HalFs() {}
+    // mode is "r", "w" (truncates) or "a"
+    virtual HalFile open(const char* path, const char* mode) = 0;
+    virtual bool exists(const char* path) = 0;
+    virtual bool remove(const char* path) = 0;
+    virtual bool rename(const char* from, const char* to) = 0;
+};
+
+enum HalFont {
+    HAL_FONT_NORMAL,  // Slider names and values
+    HAL_FONT_SMALL    // Status line
+};
+
+// Monochrome framebuffer display, in the u8g2 tile layout: 8x8 pixel tiles,
+// each tile 8 bytes of vertical pixel columns
+class HalDisplay {
+public:
+    virtual ~HalDisplay() {}
+    virtual void clearBuffer() = 0;
+    virtual void setFont(HalFont font) = 0;
+    virtual void drawStr(int x, int y, const char* text) = 0;  // y is the baseline
+    virtual void drawFrame(int x, int y, int width, int height) = 0;
+    virtual void drawBox(int x, int y, int width, int height) = 0;
+    virtual int getStrWidth(const char* text) = 0;
+    virtual int getDisplayWidth() = 0;
+    virtual uint8_t* getBufferPtr() = 0;
+    virtual int getBufferTileWidth() = 0;
+    virtual int getBufferTileHeight() = 0;
+    virtual void updateDisplayArea(int tileX, int tileY, int tileWidth, int tileHeight) = 0;
+    virtual void sendBuffer() = 0;
+};
+
+// Pin and interrupt modes
+const int HAL_INPUT_PULLUP = 0x05;
+const int HAL_LOW = 0;
+const int HAL_HIGH = 1;
+const int HAL_RISING = 0x01;
+const int HAL_FALLING = 0x02;
+const int HAL_CHANGE = 0x03;
+
+// Time
+unsigned long halMillis();
+unsigned long halMicros();
+void halDelay(unsigned long ms);
+uint32_t halCycleCount();
+uint32_t halCyclesPerMicrosecond();
+
+// GPIO, usable from interrupt handlers
+void halPinMode(int pin, int mode);
+int halDigitalRead(int pin);
+void halAttachInterrupt(int pin, void (*handler)(), int mode);
+
+// Tasks and locks (FreeRTOS on the device). A task is a step function that
+// does one round of work and returns how long to sleep before the next, so
+// the host can run tasks on its virtual clock.
+typedef void* HalMutex;
+typedef unsigned long (*HalTaskStep)();
+const int HAL_TASK_PRIORITY_LOW = 0;  // Runs whenever the loop task sleeps
+
+void halStartTask(HalTaskStep step, const char* name, uint32_t stackSize, int priority);
+HalMutex halCreateMutex();
+void halLockMutex(HalMutex mutex);
+void halUnlockMutex(HalMutex mutex);
+
+// Devices
+HalDisplay& halDisplay();
+HalFs& halFs();
+HalSerial& halSerial();
+
+// Memory
+uint32_t halFreeHeap();
+
+void halRestart();
+
+#endif
@@ -0,0 +1,149 @@
+#include "Hal.h"
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <U8g2lib.h>
+
+// Device objects defined in main.ino
+extern U8G2_SH1106_128X64_NONAME_F_HW_I2C u8g2;
+
+static_assert(HAL_INPUT_PULLUP == INPUT_PULLUP && HAL_CHANGE == CHANGE
+              && HAL_RISING == RISING && HAL_FALLING == FALLING, "HAL pin modes must match Arduino's");
+
+unsigned long halMillis() {
+    return millis();
+}
+
+unsigned long IRAM_ATTR halMicros() {
+    return micros();
+}
+
+void halDelay(unsigned long ms) {
+    delay(ms);
+}
+
+uint32_t halCycleCount() {
+    return ESP.getCycleCount();
+}
+
+uint32_t halCyclesPerMicrosecond() {
+    return ESP.getCpuFreqMHz();
+}
+
+void halPinMode(int pin, int mode) {
+    pinMode(pin, mode);
+}
+
+int IRAM_ATTR halDigitalRead(int pin) {
+    return digitalRead(pin);
+}
+
+void halAttachInterrupt(int pin, void (*handler)(), int mode) {
+    attachInterrupt(digitalPinToInterrupt(pin), handler, mode);
+}
+
+static void runTask(void* arg) {
+    HalTaskStep step = (HalTaskStep)arg;
+    for (;;) {
+        delay(step());
+    }
+}
+
+void halStartTask(HalTaskStep step, const char* name, uint32_t stackSize, int priority) {
+    xTaskCreate(runTask, name, stackSize, (void*)step, priority, nullptr);
+}
+
+HalMutex halCreateMutex() {
+    return xSemaphoreCreateMutex();
+}
+
+void halLockMutex(HalMutex mutex) {
+    xSemaphoreTake((SemaphoreHandle_t)mutex, portMAX_DELAY);
+}
+
+void halUnlockMutex(HalMutex mutex) {
+    xSemaphoreGive((SemaphoreHandle_t)mutex);
+}
+
+class Esp32Display : public HalDisplay {
+public:
+    void clearBuffer() override { u8g2.clearBuffer(); }
+    void setFont(HalFont font) override {
+        u8g2.setFont(font == HAL_FONT_SMALL ? u8g2_font_5x7_tr : u8g2_font_ncenB08_tr);
+    }
+    void drawStr(int x, int y, const char* text) override { u8g2.drawStr(x, y, text); }
+    void drawFrame(int x, int y, int width, int height) override { u8g2.drawFrame(x, y, width, height); }
+    void drawBox(int x, int y, int width, int height) override { u8g2.drawBox(x, y, width, height); }
+    int getStrWidth(const char* text) override { return u8g2.getStrWidth(text); }
+    int getDisplayWidth() override { return u8g2.getDisplayWidth(); }
+    uint8_t* getBufferPtr() override { return u8g2.getBufferPtr(); }
+    int getBufferTileWidth() override { return u8g2.getBufferTileWidth(); }
+    int getBufferTileHeight() override { return u8g2.getBufferTileHeight(); }
+    void updateDisplayArea(int tileX, int tileY, int tileWidth, int tileHeight) override {
+        u8g2.updateDisplayArea(tileX, tileY, tileWidth, tileHeight);
+    }
+    void sendBuffer() override { u8g2.sendBuffer(); }
+};
+
+class Esp32File : public HalFileImpl {
+public:
+    explicit Esp32File(const fs::File& file) : file(file) {}
+    size_t write(const uint8_t* data, size_t length) override { return file.write(data, length); }
+    size_t read(uint8_t* data, size_t length) override { return file.read(data, length); }
+    int peek() override { return file.peek(); }
+    int available() override { return file.available(); }
+    bool seek(size_t position) override { return file.seek(position); }
+    size_t size() override { return file.size(); }
+    void close() override { file.close(); }
+
+private:
+    fs::File file;
+};
+
+class Esp32Fs : public HalFs {
+public:
+    HalFile open(const char* path, const char* mode) override {
+        fs::File file = SPIFFS.open(path, mode);
+        if (!file) {
+            return HalFile();
+        }
+        return HalFile(std::make_shared<Esp32File>(file));
+    }
+    bool exists(const char* path) override { return SPIFFS.exists(path); }
+    bool remove(const char* path) override { return SPIFFS.remove(path); }
+    bool rename(const char* from, const char* to) override { return SPIFFS.rename(from, to); }
+};
+
+class Esp32Serial : public HalSerial {
+public:
+    using HalPrint::write;
+    using HalStream::read;
+    size_t write(const uint8_t* data, size_t length) override { return Serial.write(data, length); }
+    int available() override { return Serial.available(); }
+    int read() override { return Serial.read(); }
+    int peek() override { return Serial.peek(); }
+    int availableForWrite() override { return Serial.availableForWrite(); }
+};
+
+Esp32Display esp32Display;
+Esp32Fs esp32Fs;
+Esp32Serial esp32Serial;
+
+HalDisplay& halDisplay() {
+    return esp32Display;
+}
+
+HalFs& halFs() {
+    return esp32Fs;
+}
+
+HalSerial& halSerial() {
+    return esp32Serial;
+}
+
+uint32_t halFreeHeap() {
+    return ESP.getFreeHeap();
+}
+
+void halRestart() {
+    ESP.restart();
+}
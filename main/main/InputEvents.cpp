@@ -0,0 +1,99 @@
+#include "InputEvents.h"
+#include "DeejControl.h"
+#include "QuadratureDecoder.h"
+#include <atomic>
+
+InputEvent inputQueue[INPUT_QUEUE_SIZE];
+std::atomic<uint32_t> inputHead(0);  // Written only by the ISRs
+std::atomic<uint32_t> inputTail(0);  // Written only by the loop
+volatile uint32_t inputQueueOverflows = 0;
+
+QuadratureDecoder encoderDecoders[2];
+
+// Copies of the pin settings, which main.ino keeps in flash, for the ISRs
+int encoderPins[2][2];  // CLK, DT
+int buttonPins[2];
+
+// The ISRs never preempt each other, so together they are the single producer
+static void HAL_IRAM pushInputEvent(InputEventType type, uint8_t encoder, int8_t delta) {
+    uint32_t head = inputHead.load(std::memory_order_relaxed);
+    if (head - inputTail.load(std::memory_order_acquire) >= INPUT_QUEUE_SIZE) {
+        inputQueueOverflows++;
+        return;
+    }
+
+    InputEvent& event = inputQueue[head & (INPUT_QUEUE_SIZE - 1)];
+    event.timeMicros = halMicros();
+    event.type = type;
+    event.encoder = encoder;
+    event.delta = delta;
+    inputHead.store(head + 1, std::memory_order_release);
+}
+
+static uint8_t HAL_IRAM readEncoderPins(int clkPin, int dtPin) {
+    return (halDigitalRead(clkPin) ? 1 : 0) | (halDigitalRead(dtPin) ? 2 : 0);
+}
+
+static void HAL_IRAM sampleEncoder(uint8_t encoder) {
+    const int* pins = encoderPins[encoder - 1];
+    int8_t step = updateQuadratureDecoder(encoderDecoders[encoder - 1], readEncoderPins(pins[0], pins[1]));
+    if (step != 0) {
+        pushInputEvent(INPUT_ENCODER_STEP, encoder, step);
+    }
+}
+
+void HAL_IRAM encoder1ISR() {
+    sampleEncoder(1);
+}
+
+void HAL_IRAM encoder2ISR() {
+    sampleEncoder(2);
+}
+
+void HAL_IRAM button1ISR() {
+    pushInputEvent(halDigitalRead(buttonPins[0]) == HAL_LOW ? INPUT_BUTTON_DOWN : INPUT_BUTTON_UP, 1, 0);
+}
+
+void HAL_IRAM button2ISR() {
+    pushInputEvent(halDigitalRead(buttonPins[1]) == HAL_LOW ? INPUT_BUTTON_DOWN : INPUT_BUTTON_UP, 2, 0);
+}
+
+void initInputEvents() {
+    encoderPins[0][0] = ENCODER1_CLK;
+    encoderPins[0][1] = ENCODER1_DT;
+    encoderPins[1][0] = ENCODER2_CLK;
+    encoderPins[1][1] = ENCODER2_DT;
+    buttonPins[0] = ENCODER1_SW;
+    buttonPins[1] = ENCODER2_SW;
+
+    halPinMode(ENCODER1_CLK, HAL_INPUT_PULLUP);
+    halPinMode(ENCODER1_DT, HAL_INPUT_PULLUP);
+    halPinMode(ENCODER1_SW, HAL_INPUT_PULLUP);
+    halPinMode(ENCODER2_CLK, HAL_INPUT_PULLUP);
+    halPinMode(ENCODER2_DT, HAL_INPUT_PULLUP);
+    halPinMode(ENCODER2_SW, HAL_INPUT_PULLUP);
+
+    initQuadratureDecoder(encoderDecoders[0], encoder1Config, readEncoderPins(ENCODER1_CLK, ENCODER1_DT));
+    initQuadratureDecoder(encoderDecoders[1], encoder2Config, readEncoderPins(ENCODER2_CLK, ENCODER2_DT));
+
+    halAttachInterrupt(ENCODER1_CLK, encoder1ISR, HAL_CHANGE);
+    halAttachInterrupt(ENCODER1_DT, encoder1ISR, HAL_CHANGE);
+    halAttachInterrupt(ENCODER2_CLK, encoder2ISR, HAL_CHANGE);
+    halAttachInterrupt(ENCODER2_DT, encoder2ISR, HAL_CHANGE);
+    halAttachInterrupt(ENCODER1_SW, button1ISR, HAL_CHANGE);
+    halAttachInterrupt(ENCODER2_SW, button2ISR, HAL_CHANGE);
+}
+
+size_t drainInputEvents(InputEvent* events, size_t maxEvents) {
+    uint32_t tail = inputTail.load(std::memory_order_relaxed);
+    uint32_t head = inputHead.load(std::memory_order_acquire);
+
+    size_t count = 0;
+    while (tail != head && count < maxEvents) {
+        events[count++] = inputQueue[tail & (INPUT_QUEUE_SIZE - 1)];
+        tail++;
+    }
+
+    inputTail.store(tail, std::memory_order_release);
+    return count;
+}
@@ -0,0 +1,33 @@
+#ifndef INPUTEVENTS_H
+#define INPUTEVENTS_H
+
+#include "Hal.h"
+
+// Encoder and button input, captured in pin-change interrupts and handed to
+// the main loop through a fixed-size single-producer/single-consumer ring.
+// Every event carries the micros() time it happened at.
+
+enum InputEventType : uint8_t {
+    INPUT_ENCODER_STEP,  // delta is +1 or -1 detent
+    INPUT_BUTTON_DOWN,
+    INPUT_BUTTON_UP
+};
+
+struct InputEvent {
+    uint32_t timeMicros;
+    InputEventType type;
+    uint8_t encoder;  // 1 or 2, matching ENCODER1_* / ENCODER2_*
+    int8_t delta;
+};
+
+const size_t INPUT_QUEUE_SIZE = 128;  // Power of two
+
+void initInputEvents();
+
+// Moves up to maxEvents queued events into events, oldest first. Returns how many.
+size_t drainInputEvents(InputEvent* events, size_t maxEvents);
+
+// Events lost because the loop didn't drain the queue in time
+extern volatile uint32_t inputQueueOverflows;
+
+#endif
@@ -0,0 +1,64 @@
+#include "LoopProfiler.h"
+#include <string.h>
+
+#ifdef DEEJ_PROFILE
+
+// Bucket i holds samples of [2^i, 2^(i+1)) cycles, bucket 0 also holds 0
+const int PROFILE_BUCKETS = 32;
+
+struct PhaseHistogram {
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint32_t buckets[PROFILE_BUCKETS];
+};
+
+PhaseHistogram phaseHistograms[PHASE_COUNT];
+
+const char* phaseNames[PHASE_COUNT] = {
+    "serial_tx", "input", "adjust", "select", "buttons", "display", "serial", "save", "loop", "input_to_serial"
+};
+
+void resetProfile() {
+    memset(phaseHistograms, 0, sizeof(phaseHistograms));
+}
+
+void recordPhase(LoopPhase phase, uint32_t cycles) {
+    PhaseHistogram& h = phaseHistograms[phase];
+    if (h.count == 0 || cycles < h.minCycles) h.minCycles = cycles;
+    if (cycles > h.maxCycles) h.maxCycles = cycles;
+    h.count++;
+
+    int bucket = cycles == 0 ? 0 : 31 - __builtin_clz(cycles);
+    h.buckets[bucket]++;
+}
+
+// Upper bound of the bucket holding the given percentile, clamped to the max seen
+static uint32_t percentileCycles(const PhaseHistogram& h, uint32_t percent) {
+    // 64 bits, as count * percent passes 2^32 after about 43M samples
+    uint64_t target = ((uint64_t)h.count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < PROFILE_BUCKETS; i++) {
+        seen += h.buckets[i];
+        if (seen >= target) {
+            uint32_t upper = i >= 31 ? UINT32_MAX : (2u << i) - 1;
+            return upper < h.maxCycles ? upper : h.maxCycles;
+        }
+    }
+    return h.maxCycles;
+}
+
+void printProfileReport(HalPrint& out) {
+    uint32_t cyclesPerMicro = halCyclesPerMicrosecond();
+    out.print("phase count min_us p50_us p99_us max_us\n");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseHistogram& h = phaseHistograms[i];
+        out.printf("%s %u %u %u %u %u\n", phaseNames[i], (unsigned)h.count,
+                   (unsigned)(h.minCycles / cyclesPerMicro),
+                   (unsigned)(percentileCycles(h, 50) / cyclesPerMicro),
+                   (unsigned)(percentileCycles(h, 99) / cyclesPerMicro),
+                   (unsigned)(h.maxCycles / cyclesPerMicro));
+    }
+}
+
+#endif
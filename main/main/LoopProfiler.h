@@ -0,0 +1,45 @@
+#ifndef LOOPPROFILER_H
+#define LOOPPROFILER_H
+
+#include "Hal.h"
+
+// Uncomment to time each phase of runDeejControl() and report the results at
+// /profile. When disabled the PROFILE_PHASE macro is just the statement.
+// #define DEEJ_PROFILE
+
+enum LoopPhase {
+    PHASE_SERIAL_TX,        // Finishing frames and log lines left over from the last pass
+    PHASE_INPUT,
+    PHASE_ADJUST,
+    PHASE_SELECT,
+    PHASE_BUTTONS,
+    PHASE_DISPLAY,
+    PHASE_SERIAL,           // Encoding and queueing this pass's frame
+    PHASE_SAVE,
+    PHASE_LOOP,             // The whole pass, including the loop delay
+    PHASE_INPUT_TO_SERIAL,  // From the pass that saw an input to its frame leaving the TX buffer
+    PHASE_COUNT
+};
+
+#ifdef DEEJ_PROFILE
+
+// Records one sample of the given phase, in CPU cycles
+void recordPhase(LoopPhase phase, uint32_t cycles);
+
+// Per-phase count, min, p50, p99 and max in microseconds, one line per phase
+void printProfileReport(HalPrint& out);
+void resetProfile();
+
+#define PROFILE_PHASE(phase, statement) do {               \
+        uint32_t profileStart = halCycleCount();           \
+        statement;                                         \
+        recordPhase(phase, halCycleCount() - profileStart); \
+    } while (0)
+
+#else
+
+#define PROFILE_PHASE(phase, statement) do { statement; } while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+#include "Persistence.h"
+#include "SliderJournal.h"
+#include "SliderState.h"
+
+struct StateCopy {
+    bool* changed;
+    int* values;
+    bool* muted;
+    int* previousValues;
+};
+
+HalMutex persistenceMutex = nullptr;
+int persistenceCount = 0;
+uint32_t persistenceLayout = 0;
+StateCopy pendingState;   // Handed over by the loop, guarded by persistenceMutex
+StateCopy writingState;   // Owned by the task while it writes
+StateCopy savedState;     // What flash holds, for journal compaction. Owned by the task.
+bool savePending = false;
+StateCopy resetState;     // Layout from a config reload, guarded by persistenceMutex
+int resetCount = -1;      // Sliders in resetState, -1 when there is none
+uint32_t resetLayout = 0;
+bool snapshotPending = false;  // Owned by the task
+
+unsigned long persistenceWrites = 0;
+unsigned long persistenceCoalesced = 0;
+unsigned long persistenceFailures = 0;
+unsigned long persistenceLastWriteMicros = 0;
+unsigned long persistenceMaxWriteMicros = 0;
+
+static void allocateStateCopy(StateCopy& copy, int count) {
+    copy.changed = new bool[count]();
+    copy.values = new int[count];
+    copy.muted = new bool[count];
+    copy.previousValues = new int[count];
+}
+
+static void freeStateCopy(StateCopy& copy) {
+    delete[] copy.changed;
+    delete[] copy.values;
+    delete[] copy.muted;
+    delete[] copy.previousValues;
+}
+
+static void copyState(StateCopy& dst, const int* values, const bool* muted, const int* previousValues, int count) {
+    for (int i = 0; i < count; i++) {
+        dst.values[i] = values[i];
+        dst.muted[i] = muted[i];
+        dst.previousValues[i] = previousValues[i];
+    }
+}
+
+// Merges changed sliders from src into dst, keeping dst's newer entries if onlyMissing
+static void mergeState(StateCopy& dst, const StateCopy& src, bool onlyMissing) {
+    for (int i = 0; i < persistenceCount; i++) {
+        if (!src.changed[i] || (onlyMissing && dst.changed[i])) continue;
+        dst.changed[i] = true;
+        dst.values[i] = src.values[i];
+        dst.muted[i] = src.muted[i];
+        dst.previousValues[i] = src.previousValues[i];
+    }
+}
+
+// Returns false if the write failed and the changes went back to pending
+static bool writeState() {
+    unsigned long start = halMicros();
+
+    bool ok = appendJournal(writingState.changed, writingState.values, writingState.muted,
+                            writingState.previousValues, persistenceCount, persistenceLayout);
+    if (ok) {
+        mergeState(savedState, writingState, false);
+
+        // Fold the journal into a fresh snapshot once it has grown
+        if (journalSize() > JOURNAL_COMPACT_SIZE
+            && saveSliderState(savedState.values, savedState.muted, savedState.previousValues, persistenceCount,
+                               persistenceLayout)) {
+            clearJournal();
+        }
+    }
+
+    unsigned long elapsed = halMicros() - start;
+    persistenceLastWriteMicros = elapsed;
+    if (elapsed > persistenceMaxWriteMicros) persistenceMaxWriteMicros = elapsed;
+
+    if (ok) {
+        persistenceWrites++;
+    } else {
+        // Keep the failed changes for the next attempt, unless newer ones replaced them.
+        // The journal may now end in a torn record that replay stops at, so the
+        // retry goes after a fresh snapshot instead of after that record.
+        persistenceFailures++;
+        halLockMutex(persistenceMutex);
+        mergeState(pendingState, writingState, true);
+        savePending = true;
+        snapshotPending = true;
+        halUnlockMutex(persistenceMutex);
+    }
+
+    for (int i = 0; i < persistenceCount; i++) writingState.changed[i] = false;
+    return ok;
+}
+
+// Switches to the layout handed over by restartPersistence(). Called with the mutex held.
+static void takeResetState() {
+    freeStateCopy(pendingState);
+    freeStateCopy(writingState);
+    freeStateCopy(savedState);
+
+    persistenceCount = resetCount;
+    persistenceLayout = resetLayout;
+    savedState = resetState;
+    allocateStateCopy(pendingState, persistenceCount);
+    allocateStateCopy(writingState, persistenceCount);
+    resetCount = -1;
+    savePending = false;
+    snapshotPending = true;
+}
+
+static bool writeSnapshot() {
+    if (!saveSliderState(savedState.values, savedState.muted, savedState.previousValues, persistenceCount,
+                         persistenceLayout)) {
+        persistenceFailures++;
+        return false;
+    }
+    clearJournal();
+    snapshotPending = false;
+    persistenceWrites++;
+    return true;
+}
+
+static unsigned long persistenceTask() {
+    halLockMutex(persistenceMutex);
+    if (resetCount >= 0) {
+        takeResetState();
+    }
+    if (snapshotPending) {
+        // Changes made meanwhile wait in pendingState until the snapshot is written
+        halUnlockMutex(persistenceMutex);
+        return writeSnapshot() ? 20 : 1000;
+    }
+    bool haveWork = savePending;
+    if (haveWork) {
+        mergeState(writingState, pendingState, false);
+        for (int i = 0; i < persistenceCount; i++) pendingState.changed[i] = false;
+        savePending = false;
+    }
+    halUnlockMutex(persistenceMutex);
+
+    bool ok = !haveWork || writeState();
+    return ok ? 20 : 1000;  // Back off when the filesystem is failing
+}
+
+void startPersistenceTask(const int* values, const bool* muted, const int* previousValues, int count,
+                          uint32_t layout) {
+    if (persistenceMutex) {
+        return;
+    }
+
+    persistenceCount = count;
+    persistenceLayout = layout;
+    allocateStateCopy(pendingState, count);
+    allocateStateCopy(writingState, count);
+    allocateStateCopy(savedState, count);
+    copyState(savedState, values, muted, previousValues, count);
+    // Boot replayed the journal up to any record a power cut tore; appending
+    // after that record would lose everything written later
+    snapshotPending = true;
+
+    persistenceMutex = halCreateMutex();
+    halStartTask(persistenceTask, "persistence", 4096, HAL_TASK_PRIORITY_LOW);
+}
+
+void restartPersistence(const int* values, const bool* muted, const int* previousValues, int count,
+                        uint32_t layout) {
+    StateCopy copy;
+    allocateStateCopy(copy, count);
+    copyState(copy, values, muted, previousValues, count);
+
+    halLockMutex(persistenceMutex);
+    if (resetCount >= 0) {
+        freeStateCopy(resetState);
+    }
+    resetState = copy;
+    resetCount = count;
+    resetLayout = layout;
+    halUnlockMutex(persistenceMutex);
+}
+
+void requestStateSave(const uint32_t* dirty, const int* values, const bool* muted, const int* previousValues) {
+    halLockMutex(persistenceMutex);
+    if (resetCount >= 0) {
+        // The task has not taken the new layout yet; its snapshot takes the change
+        copyState(resetState, values, muted, previousValues, resetCount);
+        halUnlockMutex(persistenceMutex);
+        return;
+    }
+    if (savePending) {
+        persistenceCoalesced++;
+    }
+
+    for (int word = 0; word < (persistenceCount + 31) / 32; word++) {
+        uint32_t bits = dirty[word];
+        while (bits) {
+            int i = word * 32 + __builtin_ctz(bits);
+            bits &= bits - 1;
+            pendingState.changed[i] = true;
+            pendingState.values[i] = values[i];
+            pendingState.muted[i] = muted[i];
+            pendingState.previousValues[i] = previousValues[i];
+        }
+    }
+    savePending = true;
+    halUnlockMutex(persistenceMutex);
+}
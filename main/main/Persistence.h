@@ -0,0 +1,33 @@
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include "Hal.h"
+
+// Background slider state saving. The control loop hands over a copy of the
+// state and carries on; a low-priority task journals it to flash. If the loop
+// hands over more changes before the task got to the last ones, they are
+// merged into a single write.
+
+// Starts the task with the state that is already on flash. layout is the
+// config's sliderLayoutId(), written with every record. The task first writes
+// that state as a fresh snapshot and drops the journal.
+void startPersistenceTask(const int* values, const bool* muted, const int* previousValues, int count,
+                          uint32_t layout);
+
+// Replaces the saved state with a new slider layout after a config reload.
+// The task writes it as a fresh snapshot, since journal records use the old
+// slider indices.
+void restartPersistence(const int* values, const bool* muted, const int* previousValues, int count,
+                        uint32_t layout);
+
+// Queues the sliders whose bit is set in the dirty bitset (32 sliders per word) for saving
+void requestStateSave(const uint32_t* dirty, const int* values, const bool* muted, const int* previousValues);
+
+// Persistence statistics
+extern unsigned long persistenceWrites;
+extern unsigned long persistenceCoalesced;     // Requests merged into a pending write
+extern unsigned long persistenceFailures;
+extern unsigned long persistenceLastWriteMicros;
+extern unsigned long persistenceMaxWriteMicros;
+
+#endif
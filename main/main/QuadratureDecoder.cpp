@@ -0,0 +1,49 @@
+#include "QuadratureDecoder.h"
+#include "Hal.h"
+
+// Edge count for (old state | new state << 2). Entries marked 2 are transitions
+// where both pins changed, so the direction is unknown.
+static const int8_t HAL_DRAM quadratureTable[16] = {
+     0,  1, -1,  2,
+    -1,  0,  2,  1,
+     1,  2,  0, -1,
+     2, -1,  1,  0
+};
+
+void initQuadratureDecoder(QuadratureDecoder& decoder, const QuadratureConfig& config, uint8_t pinState) {
+    decoder.config = config;
+    if (decoder.config.countsPerDetent == 0) {
+        decoder.config.countsPerDetent = 1;
+    }
+    decoder.pinState = pinState & 3;
+    decoder.count = 0;
+    decoder.glitches = 0;
+}
+
+int8_t HAL_IRAM updateQuadratureDecoder(QuadratureDecoder& decoder, uint8_t pinState) {
+    pinState &= 3;
+    int8_t delta = quadratureTable[decoder.pinState | (pinState << 2)];
+
+    if (delta == 2) {
+        decoder.glitches++;
+        if (decoder.config.rejectGlitches) {
+            decoder.pinState = pinState;
+            return 0;
+        }
+        // Assume the missed edge continued in the direction we were already going
+        delta = decoder.count < 0 ? -2 : 2;
+    }
+    decoder.pinState = pinState;
+    decoder.count += delta;
+
+    int8_t step = 0;
+    if (decoder.count >= decoder.config.countsPerDetent) {
+        decoder.count -= decoder.config.countsPerDetent;
+        step = 1;
+    } else if (decoder.count <= -decoder.config.countsPerDetent) {
+        decoder.count += decoder.config.countsPerDetent;
+        step = -1;
+    }
+
+    return decoder.config.reversed ? -step : step;
+}
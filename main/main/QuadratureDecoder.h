@@ -0,0 +1,30 @@
+#ifndef QUADRATUREDECODER_H
+#define QUADRATUREDECODER_H
+
+#include <stdint.h>
+
+// Table-driven quadrature decoder, cheap enough to run in a pin-change ISR.
+// Pin state is bit 0 = CLK, bit 1 = DT. Counts accumulate per valid edge and a
+// step is reported once a full detent's worth has been seen, so contact bounce
+// (an edge and its reversal) cancels out instead of producing steps.
+
+struct QuadratureConfig {
+    uint8_t countsPerDetent;  // Quadrature edges per detent: 4 full-cycle, 2 half-cycle, 1
+    bool reversed;            // Swap clockwise and counter-clockwise
+    bool rejectGlitches;      // Ignore transitions where both pins changed, instead of guessing +-2
+};
+
+struct QuadratureDecoder {
+    QuadratureConfig config;
+    uint8_t pinState;
+    int8_t count;         // Edges towards the next detent
+    uint32_t glitches;    // Transitions rejected as invalid
+};
+
+void initQuadratureDecoder(QuadratureDecoder& decoder, const QuadratureConfig& config, uint8_t pinState);
+
+// Feeds the current pin state. Returns +1 or -1 when a detent completes, otherwise 0.
+// In IRAM, as the encoder ISRs call it.
+int8_t updateQuadratureDecoder(QuadratureDecoder& decoder, uint8_t pinState);
+
+#endif
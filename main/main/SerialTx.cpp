@@ -0,0 +1,236 @@
+#include "SerialTx.h"
+#include "DeejTrace.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+uint8_t* txActive = nullptr;   // Frame being written
+uint8_t* txPending = nullptr;  // Next frame, replaced by newer ones
+size_t txBufferSize = 0;
+size_t txActiveLength = 0;
+size_t txActiveOffset = 0;
+size_t txPendingLength = 0;
+
+#ifdef DEEJ_PROFILE
+uint32_t txNextInput = 0;
+uint32_t txActiveInput = 0;   // 0 when the frame carries no timed input
+uint32_t txPendingInput = 0;
+
+void markSerialInput(uint32_t inputCycles) {
+    txNextInput = inputCycles;
+}
+#endif
+
+bool txZeroDelimited = false;
+
+const size_t LOG_RING_SIZE = 512;
+const size_t LOG_LINE_LENGTH = 96;
+char txLog[LOG_RING_SIZE];
+size_t txLogHead = 0;  // Free-running; advanced by serialLog() under txLogMutex
+size_t txLogTail = 0;  // Free-running; advanced only by serviceSerialTx()
+bool txLogInLine = false;        // Part of a line is out, so the rest goes before any frame
+bool txLogDelimiterDue = false;  // A line is out but its 0x00 isn't
+HalMutex txLogMutex = nullptr;
+#ifdef DEEJ_TRACE
+char txLogTraced[LOG_LINE_LENGTH];  // The line going out, for DEEJ_TRACE_SERIAL_LOG
+size_t txLogTracedLength = 0;
+#endif
+
+bool txBlocked = false;
+unsigned long txBlockedSince = 0;
+
+unsigned long serialTxBytesWritten = 0;
+unsigned long serialTxFramesDropped = 0;
+unsigned long serialTxBlockedMicros = 0;
+unsigned long serialLogDropped = 0;
+
+void initSerialLog() {
+    if (!txLogMutex) {
+        txLogMutex = halCreateMutex();
+    }
+}
+
+void serialLog(const char* format, ...) {
+    char line[LOG_LINE_LENGTH];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line) - 2, format, args);
+    va_end(args);
+    if (length < 0) return;
+    if ((size_t)length > sizeof(line) - 3) length = sizeof(line) - 3;  // Truncated
+    line[length++] = '\r';
+    line[length++] = '\n';
+
+    halLockMutex(txLogMutex);
+    if (LOG_RING_SIZE - (txLogHead - txLogTail) < (size_t)length) {
+        serialLogDropped++;
+    } else {
+        for (int i = 0; i < length; i++) {
+            txLog[(txLogHead + i) % LOG_RING_SIZE] = line[i];
+        }
+        txLogHead += length;
+    }
+    halUnlockMutex(txLogMutex);
+}
+
+// Writes what fits of the current log line, starting the next one if none is
+// in progress. Returns false when the TX buffer is full or the ring is empty.
+bool serviceSerialLog() {
+    int space = halSerial().availableForWrite();
+    if (space <= 0) return false;
+
+    if (txLogDelimiterDue) {
+        uint8_t delimiter = 0x00;
+        if (halSerial().write(&delimiter, 1) < 1) return false;
+        txLogDelimiterDue = false;
+        return true;
+    }
+
+    halLockMutex(txLogMutex);
+    size_t waiting = txLogHead - txLogTail;
+    halUnlockMutex(txLogMutex);
+    if (waiting == 0) return false;
+
+    // Up to the end of the line, the end of the ring or the space in the TX buffer
+    uint8_t chunk[LOG_LINE_LENGTH];
+    size_t length = 0;
+    bool lineDone = false;
+    while (length < waiting && length < (size_t)space && length < sizeof(chunk) && !lineDone) {
+        chunk[length] = txLog[(txLogTail + length) % LOG_RING_SIZE];
+        lineDone = chunk[length++] == '\n';
+    }
+
+    size_t written = halSerial().write(chunk, length);
+    txLogTail += written;
+#ifdef DEEJ_TRACE
+    memcpy(txLogTraced + txLogTracedLength, chunk, written);
+    txLogTracedLength += written;
+    if (written == length && lineDone) {
+        DEEJ_TRACE_SERIAL_LOG(txLogTraced, txLogTracedLength);
+        txLogTracedLength = 0;
+    }
+#endif
+    if (written < length) {
+        txLogInLine = true;
+        return false;
+    }
+    txLogInLine = !lineDone;
+    txLogDelimiterDue = lineDone && txZeroDelimited;
+    return true;
+}
+
+void initSerialTx(size_t maxFrameSize, bool zeroDelimited) {
+    txZeroDelimited = zeroDelimited;
+
+    if (txPendingLength > 0) {
+        // Laid out for the previous config
+        serialTxFramesDropped++;
+        DEEJ_TRACE_SERIAL_DROP(txPending, txPendingLength);
+        txPendingLength = 0;
+    }
+
+    if (maxFrameSize > txBufferSize) {
+        // A frame that is partly sent is finished, so the host never sees half of one
+        uint8_t* active = new uint8_t[maxFrameSize];
+        if (txActiveLength > 0) {
+            memcpy(active, txActive, txActiveLength);
+        }
+        delete[] txActive;
+        delete[] txPending;
+        txActive = active;
+        txPending = new uint8_t[maxFrameSize];
+        txBufferSize = maxFrameSize;
+    }
+}
+
+void queueSerialFrame(const uint8_t* data, size_t length) {
+    if (length > txBufferSize) {
+        return;
+    }
+
+    if (txActiveLength == 0) {
+        memcpy(txActive, data, length);
+        txActiveLength = length;
+        txActiveOffset = 0;
+#ifdef DEEJ_PROFILE
+        txActiveInput = txNextInput;
+#endif
+    } else {
+        if (txPendingLength > 0) {
+            serialTxFramesDropped++;  // Stale frame never made it out
+            DEEJ_TRACE_SERIAL_DROP(txPending, txPendingLength);
+        }
+#ifdef DEEJ_PROFILE
+        // Latency counts from the oldest input still waiting to go out
+        if (txPendingLength == 0 || txPendingInput == 0) {
+            txPendingInput = txNextInput;
+        }
+#endif
+        memcpy(txPending, data, length);
+        txPendingLength = length;
+    }
+#ifdef DEEJ_PROFILE
+    txNextInput = 0;
+#endif
+
+    serviceSerialTx();
+}
+
+void serviceSerialTx() {
+    for (;;) {
+        // Log lines only start when no frame is waiting, but once started they finish first
+        if (txLogInLine || txLogDelimiterDue || txActiveLength == 0) {
+            if (!serviceSerialLog()) return;
+            continue;
+        }
+
+        int space = halSerial().availableForWrite();
+        if (space <= 0) {
+            if (!txBlocked) {
+                txBlocked = true;
+                txBlockedSince = halMicros();
+            }
+            return;
+        }
+
+        if (txBlocked) {
+            serialTxBlockedMicros += halMicros() - txBlockedSince;
+            txBlocked = false;
+        }
+
+        size_t chunk = txActiveLength - txActiveOffset;
+        if ((size_t)space < chunk) chunk = space;
+        size_t written = halSerial().write(txActive + txActiveOffset, chunk);
+        serialTxBytesWritten += written;
+        txActiveOffset += written;
+        if (written < chunk) {
+            return;
+        }
+
+        if (txActiveOffset >= txActiveLength) {
+            DEEJ_TRACE_SERIAL(txActive, txActiveLength);
+#ifdef DEEJ_PROFILE
+            if (txActiveInput != 0) {
+                recordPhase(PHASE_INPUT_TO_SERIAL, halCycleCount() - txActiveInput);
+            }
+            txActiveInput = txPendingInput;
+            txPendingInput = 0;
+#endif
+            // Promote the pending frame, if any
+            uint8_t* done = txActive;
+            txActive = txPending;
+            txPending = done;
+            txActiveLength = txPendingLength;
+            txActiveOffset = 0;
+            txPendingLength = 0;
+        }
+    }
+}
+
+bool serialTxIdle() {
+    return txActiveLength == 0;
+}
+
+bool serialTxPending() {
+    return txPendingLength > 0;
+}
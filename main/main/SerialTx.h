@@ -0,0 +1,39 @@
+#ifndef SERIALTX_H
+#define SERIALTX_H
+
+#include "Hal.h"
+#include "LoopProfiler.h"
+
+// Non-blocking serial output for slider frames and log lines.
+// One frame is in flight and at most one waits behind it; queueing a new frame
+// replaces a waiting one that hasn't started sending yet, since only the latest
+// values matter. serviceSerialTx() writes only what fits in the TX buffer.
+//
+// Log lines wait in a ring buffer and go out whole between frames, so they
+// never land inside one. They end in "\r\n", plus a 0x00 when frames are
+// 0x00-delimited, so a binary host can skip them.
+
+// Can be called again when the frame size changes; a frame being sent is kept
+void initSerialTx(size_t maxFrameSize, bool zeroDelimited);
+void queueSerialFrame(const uint8_t* data, size_t length);
+void serviceSerialTx();
+bool serialTxIdle();
+bool serialTxPending();  // A queued frame hasn't started sending, so the next one replaces it
+
+// Safe to call again. serialLog() works from any task once this has run.
+void initSerialLog();
+// One line, without its line ending. Dropped if the ring buffer is full.
+void serialLog(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef DEEJ_PROFILE
+// Cycle count of the input the next queued frame reports, for PHASE_INPUT_TO_SERIAL
+void markSerialInput(uint32_t inputCycles);
+#endif
+
+// Serial TX statistics
+extern unsigned long serialTxBytesWritten;
+extern unsigned long serialTxFramesDropped;
+extern unsigned long serialTxBlockedMicros;  // Time frames waited on a full TX buffer
+extern unsigned long serialLogDropped;       // Log lines that didn't fit in the ring buffer
+
+#endif
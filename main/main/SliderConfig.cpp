@@ -0,0 +1,461 @@
+#include "SliderConfig.h"
+#include <ctype.h>
+#include <string.h>
+
+static JsonToken fail(SliderConfigReader& reader, const char* error) {
+    if (!reader.error) reader.error = error;
+    return reader.token = JSON_ERROR;
+}
+
+static bool readLiteral(HalStream& in, const char* rest) {
+    for (; *rest; rest++) {
+        if (in.read() != *rest) return false;
+    }
+    return true;
+}
+
+static int hexDigit(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static JsonToken readString(SliderConfigReader& reader) {
+    HalStream& in = *reader.in;
+    size_t length = 0;
+    while (true) {
+        int c = in.read();
+        if (c < 0) return fail(reader, "Unterminated string");
+        if (c == '"') break;
+        if (c < 0x20) return fail(reader, "Control character in string");
+
+        if (c == '\\') {
+            c = in.read();
+            switch (c) {
+                case '"': case '\\': case '/': break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    int code = 0;
+                    for (int i = 0; i < 4; i++) {
+                        int digit = hexDigit(in.read());
+                        if (digit < 0) return fail(reader, "Invalid escape in string");
+                        code = code * 16 + digit;
+                    }
+                    // The display font is ASCII only
+                    c = code < 0x80 ? code : '?';
+                    break;
+                }
+                default:
+                    return fail(reader, "Invalid escape in string");
+            }
+        }
+
+        if (length < sizeof(reader.text) - 1) {
+            reader.text[length++] = c;
+        }
+    }
+    reader.text[length] = '\0';
+    return reader.token = JSON_STRING;
+}
+
+static JsonToken readNumber(SliderConfigReader& reader, int first) {
+    HalStream& in = *reader.in;
+    bool negative = first == '-';
+    bool digits = !negative;
+    long value = negative ? 0 : first - '0';
+
+    while (isdigit(in.peek())) {
+        int digit = in.read() - '0';
+        if (value < 100000000L) value = value * 10 + digit;
+        digits = true;
+    }
+    if (!digits) return fail(reader, "Invalid number");
+
+    // Fractions and exponents are valid JSON, but nothing in the config uses them
+    if (in.peek() == '.') {
+        in.read();
+        while (isdigit(in.peek())) in.read();
+    }
+    if (in.peek() == 'e' || in.peek() == 'E') {
+        in.read();
+        if (in.peek() == '+' || in.peek() == '-') in.read();
+        while (isdigit(in.peek())) in.read();
+    }
+
+    reader.number = negative ? -value : value;
+    return reader.token = JSON_NUMBER;
+}
+
+static int skipWhitespace(HalStream& in) {
+    int c;
+    do {
+        c = in.read();
+    } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+    return c;
+}
+
+static bool inObject(const SliderConfigReader& reader) {
+    return reader.depth > 0 && (reader.objects & (1u << (reader.depth - 1)));
+}
+
+// Consumes the ',' or ':' the grammar wants before the next token. c is set
+// to that token's first character, or -1 at the end of the file.
+static bool readSeparator(SliderConfigReader& reader, int& c) {
+    HalStream& in = *reader.in;
+    c = skipWhitespace(in);
+
+    if (reader.expect == JSON_EXPECT_COLON) {
+        if (c != ':') {
+            fail(reader, "Expected ':' after a key");
+            return false;
+        }
+        reader.expect = JSON_EXPECT_VALUE;
+        c = skipWhitespace(in);
+    } else if (reader.expect == JSON_EXPECT_SEPARATOR && c == ',') {
+        reader.expect = inObject(reader) ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+        c = skipWhitespace(in);
+    } else if (reader.expect == JSON_EXPECT_SEPARATOR && c != '}' && c != ']' && c != -1) {
+        fail(reader, "Expected ',' between values");
+        return false;
+    } else if (reader.expect == JSON_EXPECT_NOTHING && c != -1) {
+        fail(reader, "Unexpected data after the config");
+        return false;
+    }
+    return true;
+}
+
+// Moves the grammar on past the token just read
+static JsonToken accept(SliderConfigReader& reader, JsonToken token) {
+    bool keyPosition = reader.expect == JSON_EXPECT_KEY || reader.expect == JSON_EXPECT_FIRST_KEY;
+
+    switch (token) {
+        case JSON_BEGIN_OBJECT:
+        case JSON_BEGIN_ARRAY:
+            if (keyPosition) return fail(reader, "Expected a key");
+            if (reader.depth == JSON_MAX_DEPTH) return fail(reader, "Config is nested too deeply");
+            if (token == JSON_BEGIN_OBJECT) reader.objects |= 1u << reader.depth;
+            else reader.objects &= ~(1u << reader.depth);
+            reader.depth++;
+            reader.expect = token == JSON_BEGIN_OBJECT ? JSON_EXPECT_FIRST_KEY : JSON_EXPECT_FIRST_VALUE;
+            return reader.token = token;
+        case JSON_END_OBJECT:
+        case JSON_END_ARRAY: {
+            bool object = token == JSON_END_OBJECT;
+            if (reader.depth == 0 || inObject(reader) != object) return fail(reader, "Unexpected closing bracket");
+            if (reader.expect == JSON_EXPECT_KEY || reader.expect == JSON_EXPECT_VALUE) {
+                return fail(reader, "Trailing ','");
+            }
+            reader.depth--;
+            reader.expect = reader.depth > 0 ? JSON_EXPECT_SEPARATOR : JSON_EXPECT_NOTHING;
+            return reader.token = token;
+        }
+        case JSON_STRING:
+            if (keyPosition) {
+                reader.expect = JSON_EXPECT_COLON;
+                return reader.token = token;
+            }
+            break;
+        default:
+            if (keyPosition) return fail(reader, "Expected a key");
+            break;
+    }
+
+    // A value
+    reader.expect = reader.depth > 0 ? JSON_EXPECT_SEPARATOR : JSON_EXPECT_NOTHING;
+    return reader.token = token;
+}
+
+static JsonToken nextToken(SliderConfigReader& reader) {
+    if (reader.token == JSON_ERROR) return JSON_ERROR;
+
+    HalStream& in = *reader.in;
+    int c;
+    if (!readSeparator(reader, c)) return JSON_ERROR;
+
+    switch (c) {
+        case -1: return reader.token = JSON_END;
+        case '{': return accept(reader, JSON_BEGIN_OBJECT);
+        case '}': return accept(reader, JSON_END_OBJECT);
+        case '[': return accept(reader, JSON_BEGIN_ARRAY);
+        case ']': return accept(reader, JSON_END_ARRAY);
+        case '"': return readString(reader) == JSON_STRING ? accept(reader, JSON_STRING) : JSON_ERROR;
+        case 't': return readLiteral(in, "rue") ? accept(reader, JSON_TRUE) : fail(reader, "Invalid literal");
+        case 'f': return readLiteral(in, "alse") ? accept(reader, JSON_FALSE) : fail(reader, "Invalid literal");
+        case 'n': return readLiteral(in, "ull") ? accept(reader, JSON_NULL) : fail(reader, "Invalid literal");
+        default:
+            if (c == '-' || isdigit(c)) {
+                return readNumber(reader, c) == JSON_NUMBER ? accept(reader, JSON_NUMBER) : JSON_ERROR;
+            }
+            return fail(reader, "Unexpected character");
+    }
+}
+
+// Skips the value whose first token was just read
+static bool skipValue(SliderConfigReader& reader) {
+    int depth = 0;
+    while (true) {
+        switch (reader.token) {
+            case JSON_BEGIN_OBJECT:
+            case JSON_BEGIN_ARRAY:
+                depth++;
+                break;
+            case JSON_END_OBJECT:
+            case JSON_END_ARRAY:
+                if (--depth < 0) {
+                    fail(reader, "Unexpected closing bracket");
+                    return false;
+                }
+                break;
+            case JSON_END:
+                fail(reader, "Unexpected end of file");
+                return false;
+            case JSON_ERROR:
+                return false;
+            default:
+                break;
+        }
+        if (depth == 0) return true;
+        nextToken(reader);
+    }
+}
+
+static bool readInt(SliderConfigReader& reader, int& value, const char* error) {
+    if (nextToken(reader) != JSON_NUMBER) {
+        fail(reader, error);
+        return false;
+    }
+    value = reader.number;
+    return true;
+}
+
+// Reads the next key of an object. False at its end, or on an error.
+static bool nextKey(SliderConfigReader& reader) {
+    JsonToken token = nextToken(reader);
+    if (token == JSON_STRING) return true;
+    if (token == JSON_END) fail(reader, "Unexpected end of file");
+    if (token != JSON_END_OBJECT) fail(reader, "Expected a key");
+    return false;
+}
+
+// Reads the next element of the current array, which must be an object
+static bool nextArrayObject(SliderConfigReader& reader, const char* error) {
+    if (!reader.inArray) return false;
+
+    JsonToken token = nextToken(reader);
+    if (token == JSON_END_ARRAY) {
+        reader.inArray = false;
+        return false;
+    }
+    if (token != JSON_BEGIN_OBJECT) {
+        fail(reader, token == JSON_END ? "Unexpected end of file" : error);
+        return false;
+    }
+    return true;
+}
+
+void beginConfigRead(SliderConfigReader& reader, HalStream& in) {
+    memset(&reader, 0, sizeof(reader));
+    reader.in = &in;
+    reader.token = JSON_END;
+}
+
+SliderConfigSection nextConfigSection(SliderConfigReader& reader) {
+    if (reader.token == JSON_ERROR) return CONFIG_ERROR;
+
+    if (!reader.started) {
+        reader.started = true;
+        if (nextToken(reader) != JSON_BEGIN_OBJECT) {
+            fail(reader, "Config must be an object");
+            return CONFIG_ERROR;
+        }
+    }
+
+    // Whatever the caller did not read of the previous section
+    while (reader.inArray) {
+        if (nextToken(reader) == JSON_END_ARRAY) {
+            reader.inArray = false;
+        } else if (!skipValue(reader)) {
+            return CONFIG_ERROR;
+        }
+    }
+
+    while (nextKey(reader)) {
+        if (strcmp(reader.text, "num_sliders") == 0) {
+            if (!readInt(reader, reader.numSliders, "num_sliders must be a number")) break;
+            return CONFIG_NUM_SLIDERS;
+        }
+
+        bool sliders = strcmp(reader.text, "sliders") == 0;
+        if (sliders || strcmp(reader.text, "acceleration") == 0) {
+            if (nextToken(reader) != JSON_BEGIN_ARRAY) {
+                fail(reader, sliders ? "sliders must be an array" : "acceleration must be an array");
+                break;
+            }
+            reader.inArray = true;
+            return sliders ? CONFIG_SLIDERS : CONFIG_ACCELERATION;
+        }
+
+        nextToken(reader);
+        if (!skipValue(reader)) break;
+    }
+
+    return reader.token == JSON_ERROR ? CONFIG_ERROR : CONFIG_END;
+}
+
+bool nextConfigSlider(SliderConfigReader& reader, SliderConfigEntry& entry) {
+    if (!nextArrayObject(reader, "Slider entries must be objects")) return false;
+
+    entry.name[0] = '\0';
+    entry.value = 50;
+    entry.muted = false;
+    bool hasPreviousValue = false;
+
+    while (nextKey(reader)) {
+        if (strcmp(reader.text, "name") == 0) {
+            if (nextToken(reader) != JSON_STRING) {
+                fail(reader, "Slider name must be a string");
+                return false;
+            }
+            strcpy(entry.name, reader.text);
+        } else if (strcmp(reader.text, "value") == 0) {
+            if (!readInt(reader, entry.value, "Slider value must be a number")) return false;
+        } else if (strcmp(reader.text, "previous_value") == 0) {
+            if (!readInt(reader, entry.previousValue, "Slider previous_value must be a number")) return false;
+            hasPreviousValue = true;
+        } else if (strcmp(reader.text, "muted") == 0) {
+            JsonToken token = nextToken(reader);
+            if (token != JSON_TRUE && token != JSON_FALSE) {
+                fail(reader, "Slider muted must be true or false");
+                return false;
+            }
+            entry.muted = token == JSON_TRUE;
+        } else {
+            nextToken(reader);
+            if (!skipValue(reader)) return false;
+        }
+    }
+    if (!hasPreviousValue) entry.previousValue = entry.value;
+
+    return reader.token != JSON_ERROR;
+}
+
+bool nextConfigAccelerationPoint(SliderConfigReader& reader, int& intervalMs, int& step) {
+    if (!nextArrayObject(reader, "Acceleration points must be objects")) return false;
+
+    intervalMs = -1;
+    step = 0;
+    while (nextKey(reader)) {
+        if (strcmp(reader.text, "interval_ms") == 0) {
+            if (!readInt(reader, intervalMs, "interval_ms must be a number")) return false;
+        } else if (strcmp(reader.text, "step") == 0) {
+            if (!readInt(reader, step, "step must be a number")) return false;
+        } else {
+            nextToken(reader);
+            if (!skipValue(reader)) return false;
+        }
+    }
+
+    return reader.token != JSON_ERROR;
+}
+
+const char* scanSliderConfig(HalStream& in, int maxSliders, SliderConfigSummary& summary) {
+    SliderConfigReader reader;
+    SliderConfigEntry entry;
+    SliderConfigSection section;
+    int intervalMs, step;
+    int entries = -1;
+    memset(&summary, 0, sizeof(summary));
+
+    beginConfigRead(reader, in);
+    while ((section = nextConfigSection(reader)) > CONFIG_END) {
+        if (section == CONFIG_SLIDERS) {
+            entries = 0;
+            while (nextConfigSlider(reader, entry)) {
+                entries++;
+                summary.nameBytes += strlen(entry.name) + 1;
+                if (entry.value < 0 || entry.value > 100 || entry.previousValue < 0 || entry.previousValue > 100) {
+                    return "Slider values must be between 0 and 100";
+                }
+            }
+        } else if (section == CONFIG_ACCELERATION) {
+            while (nextConfigAccelerationPoint(reader, intervalMs, step)) {
+                if (summary.numAccelerationPoints == MAX_ACCELERATION_POINTS) continue;
+                if (intervalMs < 0 || intervalMs > UINT16_MAX || step < 1 || step > 100) continue;
+                AccelerationPoint& point = summary.acceleration[summary.numAccelerationPoints++];
+                point.intervalMs = intervalMs;
+                point.step = step;
+            }
+        }
+    }
+
+    if (section == CONFIG_ERROR) return reader.error;
+    if (nextToken(reader) != JSON_END) return reader.error ? reader.error : "Unexpected data after the config";
+    if (reader.numSliders <= 0) return "num_sliders must be at least 1";
+    if (reader.numSliders > maxSliders) return "Too many sliders for the serial protocol";
+    if (entries < 0) return "Config has no sliders array";
+    if (entries != reader.numSliders) return "num_sliders does not match the sliders array";
+    summary.numSliders = reader.numSliders;
+    return nullptr;
+}
+
+bool replaceSliderConfig(const char* path) {
+    HalFs& fs = halFs();
+    // SPIFFS cannot rename over an existing file
+    fs.remove(SLIDER_CONFIG_BACKUP_PATH);
+    if (fs.exists(SLIDER_CONFIG_PATH) && !fs.rename(SLIDER_CONFIG_PATH, SLIDER_CONFIG_BACKUP_PATH)) {
+        return false;
+    }
+    if (!fs.rename(path, SLIDER_CONFIG_PATH)) {
+        fs.rename(SLIDER_CONFIG_BACKUP_PATH, SLIDER_CONFIG_PATH);
+        return false;
+    }
+    fs.remove(SLIDER_CONFIG_BACKUP_PATH);
+    return true;
+}
+
+void recoverSliderConfig() {
+    HalFs& fs = halFs();
+    if (!fs.exists(SLIDER_CONFIG_PATH) && fs.exists(SLIDER_CONFIG_BACKUP_PATH)) {
+        fs.rename(SLIDER_CONFIG_BACKUP_PATH, SLIDER_CONFIG_PATH);
+    }
+}
+
+static void writeString(HalPrint& out, const char* text) {
+    out.print('"');
+    for (; *text; text++) {
+        if (*text == '"' || *text == '\\') {
+            out.print('\\');
+            out.print(*text);
+        } else if ((uint8_t)*text < 0x20) {
+            out.printf("\\u%04x", *text);
+        } else {
+            out.print(*text);
+        }
+    }
+    out.print('"');
+}
+
+void beginConfigWrite(SliderConfigWriter& writer, HalPrint& out, int numSliders) {
+    writer.out = &out;
+    writer.written = 0;
+    out.printf("{\"num_sliders\":%d,\"sliders\":[", numSliders);
+}
+
+void writeConfigSlider(SliderConfigWriter& writer, const SliderConfigEntry& entry) {
+    HalPrint& out = *writer.out;
+    if (writer.written++ > 0) out.print(',');
+
+    out.print("{\"name\":");
+    writeString(out, entry.name);
+    out.printf(",\"value\":%d,\"muted\":%s,\"previous_value\":%d}",
+               entry.value, entry.muted ? "true" : "false", entry.previousValue);
+}
+
+void endConfigWrite(SliderConfigWriter& writer) {
+    writer.out->print("]}");
+}
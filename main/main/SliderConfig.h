@@ -0,0 +1,119 @@
+#ifndef SLIDERCONFIG_H
+#define SLIDERCONFIG_H
+
+#include "Hal.h"
+#include "Acceleration.h"
+
+// Pull parser and writer for sliders_config.json. Entries are read and
+// written one at a time straight from the file, so memory use does not grow
+// with the number of sliders.
+//
+//   SliderConfigReader reader;
+//   beginConfigRead(reader, file);
+//   while ((section = nextConfigSection(reader)) > CONFIG_END) {
+//       if (section == CONFIG_SLIDERS)
+//           while (nextConfigSlider(reader, entry)) ...
+//   }
+
+const char* const SLIDER_CONFIG_PATH = "/sliders_config.json";
+const char* const SLIDER_CONFIG_UPLOAD_PATH = "/sliders_config.tmp";
+const char* const SLIDER_CONFIG_BACKUP_PATH = "/sliders_config.bak";
+const int SLIDER_NAME_LENGTH = 64;  // Longer names are cut
+
+struct SliderConfigEntry {
+    char name[SLIDER_NAME_LENGTH];
+    int value;
+    bool muted;
+    int previousValue;
+};
+
+enum SliderConfigSection {
+    CONFIG_ERROR = -1,
+    CONFIG_END = 0,
+    CONFIG_NUM_SLIDERS,  // reader.numSliders is set
+    CONFIG_SLIDERS,      // Pull entries with nextConfigSlider()
+    CONFIG_ACCELERATION  // Pull points with nextConfigAccelerationPoint()
+};
+
+enum JsonToken : uint8_t {
+    JSON_BEGIN_OBJECT,
+    JSON_END_OBJECT,
+    JSON_BEGIN_ARRAY,
+    JSON_END_ARRAY,
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL,
+    JSON_END,
+    JSON_ERROR
+};
+
+// Where the reader is in the JSON grammar, which decides the separator that
+// must come before the next token
+enum JsonExpect : uint8_t {
+    JSON_EXPECT_VALUE,        // Document start, after ':' or after ',' in an array
+    JSON_EXPECT_FIRST_VALUE,  // After '[': a value or ']'
+    JSON_EXPECT_KEY,          // After ',' in an object
+    JSON_EXPECT_FIRST_KEY,    // After '{': a key or '}'
+    JSON_EXPECT_COLON,        // After a key
+    JSON_EXPECT_SEPARATOR,    // After a value in a container: ',' or its closing bracket
+    JSON_EXPECT_NOTHING       // After the top-level value
+};
+
+const int JSON_MAX_DEPTH = 32;
+
+struct SliderConfigReader {
+    HalStream* in;
+    JsonToken token;
+    JsonExpect expect;
+    uint8_t depth;
+    uint32_t objects;               // Bit per nesting level, set where it is an object
+    char text[SLIDER_NAME_LENGTH];  // Last string token
+    long number;                    // Last number token
+    bool inArray;                   // A section's array is not fully read yet
+    bool started;
+    int numSliders;
+    const char* error;              // Set once the file is found invalid
+};
+
+void beginConfigRead(SliderConfigReader& reader, HalStream& in);
+
+// Skips whatever is left of the previous section, then reads up to the next
+// one it knows. Unknown keys are skipped.
+SliderConfigSection nextConfigSection(SliderConfigReader& reader);
+
+// False at the end of the array, or on an error
+bool nextConfigSlider(SliderConfigReader& reader, SliderConfigEntry& entry);
+bool nextConfigAccelerationPoint(SliderConfigReader& reader, int& intervalMs, int& step);
+
+// What loading a config needs to know before reading its sliders
+struct SliderConfigSummary {
+    int numSliders;
+    size_t nameBytes;  // All names with their terminators
+    AccelerationPoint acceleration[MAX_ACCELERATION_POINTS];
+    int numAccelerationPoints;  // Points out of range are left out
+};
+
+// Reads a whole config and checks everything loading it relies on, with at
+// most maxSliders sliders. Returns null if it is valid, otherwise why not.
+// Both the loader and the upload check go through this.
+const char* scanSliderConfig(HalStream& in, int maxSliders, SliderConfigSummary& summary);
+
+// Makes the file at path the live config. The old one is kept as a backup
+// until the new one is in place, so a power cut leaves one of them to load.
+bool replaceSliderConfig(const char* path);
+
+// Puts the backup back if a replace was interrupted. Call before loading.
+void recoverSliderConfig();
+
+struct SliderConfigWriter {
+    HalPrint* out;
+    int written;
+};
+
+void beginConfigWrite(SliderConfigWriter& writer, HalPrint& out, int numSliders);
+void writeConfigSlider(SliderConfigWriter& writer, const SliderConfigEntry& entry);
+void endConfigWrite(SliderConfigWriter& writer);
+
+#endif
@@ -0,0 +1,93 @@
+#include "SliderJournal.h"
+#include "SliderProtocol.h"
+#include "DeejTrace.h"
+
+// Record: magic, slider (2 bytes LE), value, previous value, flags, layout (4 bytes LE),
+// CRC16 (2 bytes LE)
+const uint8_t JOURNAL_MAGIC = 0xA5;
+const uint8_t JOURNAL_FLAG_MUTED = 0x01;
+
+const size_t JOURNAL_CRC_OFFSET = JOURNAL_RECORD_SIZE - 2;
+
+bool appendJournal(const bool* changed, const int* values, const bool* muted, const int* previousValues, int count,
+                   uint32_t layout) {
+    HalFile file = halFs().open(JOURNAL_PATH, "a");
+    if (!file) {
+        return false;
+    }
+
+    size_t written = 0;
+    size_t expected = 0;
+    for (int i = 0; i < count; i++) {
+        if (!changed[i]) continue;
+
+        uint8_t record[JOURNAL_RECORD_SIZE];
+        record[0] = JOURNAL_MAGIC;
+        record[1] = i & 0xFF;
+        record[2] = i >> 8;
+        record[3] = values[i];
+        record[4] = previousValues[i];
+        record[5] = muted[i] ? JOURNAL_FLAG_MUTED : 0;
+        record[6] = layout;
+        record[7] = layout >> 8;
+        record[8] = layout >> 16;
+        record[9] = layout >> 24;
+        uint16_t crc = crc16(record, JOURNAL_CRC_OFFSET);
+        record[10] = crc & 0xFF;
+        record[11] = crc >> 8;
+
+        written += file.write(record, sizeof(record));
+        expected += sizeof(record);
+    }
+    file.close();
+    DEEJ_TRACE_FS_WRITE(JOURNAL_PATH, written);
+
+    return written == expected;
+}
+
+int replayJournal(int* values, bool* muted, int* previousValues, int count, uint32_t layout) {
+    if (!halFs().exists(JOURNAL_PATH)) {
+        return 0;
+    }
+
+    HalFile file = halFs().open(JOURNAL_PATH, "r");
+    if (!file) {
+        return 0;
+    }
+
+    int applied = 0;
+    uint8_t record[JOURNAL_RECORD_SIZE];
+    while (file.read(record, sizeof(record)) == sizeof(record)) {
+        uint16_t crc = record[10] | (record[11] << 8);
+        if (record[0] != JOURNAL_MAGIC || crc16(record, JOURNAL_CRC_OFFSET) != crc) {
+            break;  // Torn or corrupt tail, nothing after it can be trusted
+        }
+
+        uint32_t recordLayout = (uint32_t)record[6] | ((uint32_t)record[7] << 8)
+                              | ((uint32_t)record[8] << 16) | ((uint32_t)record[9] << 24);
+        int slider = record[1] | (record[2] << 8);
+        if (recordLayout != layout || slider >= count) continue;  // Written for another config
+
+        values[slider] = record[3];
+        previousValues[slider] = record[4];
+        muted[slider] = record[5] & JOURNAL_FLAG_MUTED;
+        applied++;
+    }
+    file.close();
+
+    return applied;
+}
+
+size_t journalSize() {
+    if (!halFs().exists(JOURNAL_PATH)) {
+        return 0;
+    }
+    HalFile file = halFs().open(JOURNAL_PATH, "r");
+    size_t size = file ? file.size() : 0;
+    file.close();
+    return size;
+}
+
+void clearJournal() {
+    halFs().remove(JOURNAL_PATH);
+}
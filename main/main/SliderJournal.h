@@ -0,0 +1,29 @@
+#ifndef SLIDERJOURNAL_H
+#define SLIDERJOURNAL_H
+
+#include "Hal.h"
+
+// Append-only log of slider state changes, so a save writes a few bytes
+// instead of rewriting the whole config. Each record holds the full state of
+// one slider and a CRC; replaying them in order over the last snapshot gives
+// the latest state. A torn record at the end (power loss mid-append) fails
+// its CRC and replay stops there. Records carry the sliderLayoutId() they
+// were written for, and replay skips those of any other layout.
+
+const char* const JOURNAL_PATH = "/sliders_state.jrnl";
+const size_t JOURNAL_RECORD_SIZE = 12;
+const size_t JOURNAL_COMPACT_SIZE = 4096;  // Fold into a snapshot past this size
+
+// Appends one record per slider whose bit is set in changed
+bool appendJournal(const bool* changed, const int* values, const bool* muted, const int* previousValues, int count,
+                   uint32_t layout);
+
+// Applies every valid record of this layout to the arrays. Returns the number of records applied.
+int replayJournal(int* values, bool* muted, int* previousValues, int count, uint32_t layout);
+
+size_t journalSize();
+
+// Call once a snapshot holding the journalled state has been written
+void clearJournal();
+
+#endif
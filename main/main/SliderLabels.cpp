@@ -0,0 +1,59 @@
+#include "SliderLabels.h"
+#include "DisplayRenderer.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* const valueLabels[101] = {
+    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
+    "10", "11", "12", "13", "14", "15", "16", "17", "18", "19",
+    "20", "21", "22", "23", "24", "25", "26", "27", "28", "29",
+    "30", "31", "32", "33", "34", "35", "36", "37", "38", "39",
+    "40", "41", "42", "43", "44", "45", "46", "47", "48", "49",
+    "50", "51", "52", "53", "54", "55", "56", "57", "58", "59",
+    "60", "61", "62", "63", "64", "65", "66", "67", "68", "69",
+    "70", "71", "72", "73", "74", "75", "76", "77", "78", "79",
+    "80", "81", "82", "83", "84", "85", "86", "87", "88", "89",
+    "90", "91", "92", "93", "94", "95", "96", "97", "98", "99",
+    "100",
+};
+
+SliderLabel* sliderLabels = nullptr;
+int sliderLabelCount = 0;
+
+void buildSliderLabels(const char* const* names, int count) {
+    if (count > sliderLabelCount) {
+        delete[] sliderLabels;
+        sliderLabels = new SliderLabel[count];
+    }
+    sliderLabelCount = count;
+
+    lockDisplay();
+    HalDisplay& display = halDisplay();
+    display.setFont(HAL_FONT_NORMAL);
+    int maxWidth = display.getDisplayWidth();
+
+    for (int i = 0; i < count; i++) {
+        SliderLabel& label = sliderLabels[i];
+        char suffix[32];  // Room for two full ints, so the format never truncates
+        snprintf(suffix, sizeof(suffix), " (%d/%d)", i + 1, count);
+
+        // Drop characters from the end of the name until the whole header fits
+        int nameLength = strlen(names[i]);
+        int maxNameLength = SLIDER_LABEL_LENGTH - 1 - strlen(suffix);
+        if (nameLength > maxNameLength) nameLength = maxNameLength;
+        int width;
+        do {
+            snprintf(label.text, sizeof(label.text), "%.*s%s", nameLength, names[i], suffix);
+            width = display.getStrWidth(label.text);
+        } while (width > maxWidth && --nameLength > 0);
+    }
+    unlockDisplay();
+}
+
+const SliderLabel& sliderLabel(int slider) {
+    return sliderLabels[slider];
+}
+
+const char* valueLabel(int value) {
+    return valueLabels[value < 0 ? 0 : value > 100 ? 100 : value];
+}
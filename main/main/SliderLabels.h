@@ -0,0 +1,23 @@
+#ifndef SLIDERLABELS_H
+#define SLIDERLABELS_H
+
+#include <stdint.h>
+
+// Display text prepared once per config load, so drawing a frame is only lookups
+
+const int SLIDER_LABEL_LENGTH = 40;
+
+struct SliderLabel {
+    char text[SLIDER_LABEL_LENGTH];  // "Name (2/5)", shortened to fit the screen
+};
+
+// Rebuilds the header labels for the given names. Measures with the display,
+// so it takes the display lock.
+void buildSliderLabels(const char* const* names, int count);
+
+const SliderLabel& sliderLabel(int slider);
+
+// "0" to "100"
+const char* valueLabel(int value);
+
+#endif
@@ -0,0 +1,79 @@
+#include "SliderPool.h"
+
+#include <new>
+#include <string.h>
+
+static size_t carve(size_t& offset, size_t size, size_t align) {
+    offset = (offset + align - 1) & ~(align - 1);
+    size_t start = offset;
+    offset += size;
+    return start;
+}
+
+int dirtyWords(const SliderPool& pool) {
+    return (pool.count + 31) / 32;
+}
+
+void freeSliderPool(SliderPool& pool) {
+    delete[] pool.arena;
+    memset(&pool, 0, sizeof(pool));
+}
+
+bool initSliderPool(SliderPool& pool, int count, int dirtySets, size_t frameSize, size_t nameBytes) {
+    freeSliderPool(pool);
+    if (count <= 0) return false;
+
+    // Widest alignment first, so padding only ever happens once
+    size_t words = (count + 31) / 32;
+    size_t offset = 0;
+    size_t names = carve(offset, count * sizeof(const char*), alignof(const char*));
+    size_t values = carve(offset, count * sizeof(int), alignof(int));
+    size_t previousValues = carve(offset, count * sizeof(int), alignof(int));
+    size_t dirty = carve(offset, dirtySets * words * sizeof(uint32_t), alignof(uint32_t));
+    size_t muted = carve(offset, count * sizeof(bool), 1);
+    size_t mask = carve(offset, (count + 7) / 8, 1);
+    size_t queuedMask = carve(offset, (count + 7) / 8, 1);
+    size_t frame = carve(offset, frameSize, 1);
+    size_t namePool = carve(offset, nameBytes, 1);
+
+    uint8_t* arena = new (std::nothrow) uint8_t[offset]();
+    if (!arena) return false;
+
+    pool.arena = arena;
+    pool.bytes = offset;
+    pool.count = count;
+    pool.names = (const char**)(arena + names);
+    pool.values = (int*)(arena + values);
+    pool.previousValues = (int*)(arena + previousValues);
+    pool.dirty = (uint32_t*)(arena + dirty);
+    pool.muted = (bool*)(arena + muted);
+    pool.mask = arena + mask;
+    pool.queuedMask = arena + queuedMask;
+    pool.frame = (char*)(arena + frame);
+    pool.frameSize = frameSize;
+    pool.namePool = (char*)(arena + namePool);
+    pool.nameSize = nameBytes;
+    pool.nameUsed = 0;
+
+    for (int i = 0; i < count; i++) {
+        pool.names[i] = "";
+    }
+    return true;
+}
+
+void setSliderName(SliderPool& pool, int slider, const char* name) {
+    for (int i = 0; i < slider; i++) {
+        if (strcmp(pool.names[i], name) == 0) {
+            pool.names[slider] = pool.names[i];
+            return;
+        }
+    }
+
+    size_t length = strlen(name) + 1;
+    if (pool.nameUsed + length > pool.nameSize) return;  // Keeps ""
+
+    char* copy = pool.namePool + pool.nameUsed;
+    memcpy(copy, name, length);
+    pool.nameUsed += length;
+    pool.names[slider] = copy;
+}
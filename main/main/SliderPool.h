@@ -0,0 +1,41 @@
+#ifndef SLIDERPOOL_H
+#define SLIDERPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Everything sized from the slider count lives in one allocation, so loading
+// a new config releases the previous one in a single step. Each field is a
+// contiguous array, since the hot paths (frame encoding, saving) walk one
+// field across all sliders.
+
+struct SliderPool {
+    int count;
+    uint32_t layout;     // sliderLayoutId() of the names, set by the loader
+    int* values;
+    int* previousValues;
+    uint32_t* dirty;     // dirtyWords() words per consumer bitset
+    const char** names;  // Point into the name pool
+    bool* muted;
+    uint8_t* mask;       // Scratch for binary delta masks
+    uint8_t* queuedMask; // Mask of the binary frame waiting in SerialTx
+    char* frame;         // Serial frame buffer
+    size_t frameSize;
+    char* namePool;
+    size_t nameUsed;
+    size_t nameSize;
+    size_t bytes;        // Size of the whole allocation
+    uint8_t* arena;
+};
+
+// Releases the previous allocation and zeroes everything in the new one.
+// nameBytes is the length of all names together, terminators included.
+bool initSliderPool(SliderPool& pool, int count, int dirtySets, size_t frameSize, size_t nameBytes);
+void freeSliderPool(SliderPool& pool);
+
+int dirtyWords(const SliderPool& pool);
+
+// Copies name into the pool. Names that are already there are shared.
+void setSliderName(SliderPool& pool, int slider, const char* name);
+
+#endif
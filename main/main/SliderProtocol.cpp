@@ -0,0 +1,141 @@
+#include "SliderProtocol.h"
+#include "DeejFrame.h"
+
+uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeIndex = 0;
+    size_t outIndex = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] != 0) {
+            out[outIndex++] = in[i];
+            code++;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+    }
+    out[codeIndex] = code;
+    return outIndex;
+}
+
+size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t inIndex = 0;
+    size_t outIndex = 0;
+
+    while (inIndex < length) {
+        uint8_t code = in[inIndex++];
+        if (code == 0 || inIndex + code - 1 > length) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            out[outIndex++] = in[inIndex++];
+        }
+        if (code != 0xFF && inIndex < length) {
+            out[outIndex++] = 0;
+        }
+    }
+    return outIndex;
+}
+
+static size_t rawPacketSize(int count, int included) {
+    return 2 + (count + 7) / 8 + (included * 10 + 7) / 8 + 2;
+}
+
+size_t sliderPacketBufferSize(int count) {
+    size_t raw = rawPacketSize(count, count);
+    return raw + raw / 254 + 2;
+}
+
+size_t encodeSliderPacket(uint8_t* out, size_t outSize, uint8_t sequence,
+                          const int* values, const uint8_t* mask, int count) {
+    if (count < 0 || count > SLIDER_PACKET_MAX_SLIDERS || outSize < sliderPacketBufferSize(count)) {
+        return 0;
+    }
+
+    uint8_t raw[SLIDER_PACKET_MAX_RAW] = {0};
+    size_t maskBytes = (count + 7) / 8;
+    raw[0] = sequence;
+    raw[1] = (uint8_t)count;
+
+    uint8_t* packed = raw + 2 + maskBytes;
+    uint32_t bitPos = 0;
+    for (int i = 0; i < count; i++) {
+        if (mask && !(mask[i / 8] & (1 << (i % 8)))) continue;
+        raw[2 + i / 8] |= 1 << (i % 8);
+
+        uint16_t value = deejValue(values[i]);
+        for (int bit = 0; bit < 10; bit++, bitPos++) {
+            if (value & (1 << bit))
+                packed[bitPos / 8] |= 1 << (bitPos % 8);
+        }
+    }
+
+    size_t length = 2 + maskBytes + (bitPos + 7) / 8;
+    uint16_t crc = crc16(raw, length);
+    raw[length++] = crc >> 8;
+    raw[length++] = crc & 0xFF;
+
+    size_t encoded = cobsEncode(raw, length, out);
+    out[encoded++] = 0x00;
+    return encoded;
+}
+
+bool decodeSliderPacket(const uint8_t* frame, size_t length, SliderPacket& packet) {
+    uint8_t raw[SLIDER_PACKET_MAX_RAW + 2];
+    if (length > sizeof(raw)) {
+        return false;
+    }
+
+    size_t rawLength = cobsDecode(frame, length, raw);
+    if (rawLength < 4) {
+        return false;
+    }
+
+    uint16_t crc = (raw[rawLength - 2] << 8) | raw[rawLength - 1];
+    if (crc16(raw, rawLength - 2) != crc) {
+        return false;
+    }
+
+    packet.sequence = raw[0];
+    packet.count = raw[1];
+    size_t maskBytes = (packet.count + 7) / 8;
+    if (rawLength < 2 + maskBytes + 2) {
+        return false;
+    }
+
+    int included = 0;
+    for (size_t i = 0; i < maskBytes; i++) {
+        packet.mask[i] = raw[2 + i];
+        included += __builtin_popcount(raw[2 + i]);
+    }
+    if (rawLength != rawPacketSize(packet.count, included)) {
+        return false;
+    }
+
+    const uint8_t* packed = raw + 2 + maskBytes;
+    uint32_t bitPos = 0;
+    for (int i = 0; i < packet.count; i++) {
+        if (!(packet.mask[i / 8] & (1 << (i % 8)))) continue;
+
+        uint16_t value = 0;
+        for (int bit = 0; bit < 10; bit++, bitPos++) {
+            if (packed[bitPos / 8] & (1 << (bitPos % 8)))
+                value |= 1 << bit;
+        }
+        packet.values[i] = value;
+    }
+    return true;
+}
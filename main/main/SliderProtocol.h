@@ -0,0 +1,45 @@
+#ifndef SLIDERPROTOCOL_H
+#define SLIDERPROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary slider frames, an alternative to deej's "a|b|c" text lines.
+//
+// Packet (before framing):
+//   sequence    1 byte, incremented per frame so the host can spot drops;
+//               a frame that replaces an unsent one takes over its number
+//   count       1 byte, total number of sliders
+//   mask        (count + 7) / 8 bytes, bit i set if slider i is included
+//   values      10 bits (0-1023) per included slider, packed LSB first
+//   crc         CRC16-CCITT of everything above, big-endian
+//
+// The packet is COBS-encoded and terminated with a 0x00 byte.
+
+const int SLIDER_PACKET_MAX_SLIDERS = 255;
+const size_t SLIDER_PACKET_MAX_RAW = 2 + 32 + (SLIDER_PACKET_MAX_SLIDERS * 10 + 7) / 8 + 2;
+
+struct SliderPacket {
+    uint8_t sequence;
+    int count;
+    uint8_t mask[(SLIDER_PACKET_MAX_SLIDERS + 7) / 8];
+    uint16_t values[SLIDER_PACKET_MAX_SLIDERS];  // Only valid where the mask bit is set
+};
+
+// Buffer size for an encoded frame of count sliders, including the delimiter
+size_t sliderPacketBufferSize(int count);
+
+// Encodes the 0-100 slider values whose bit is set in mask (all of them if mask is nullptr).
+// Returns the frame length including the delimiter, or 0 if out is too small.
+size_t encodeSliderPacket(uint8_t* out, size_t outSize, uint8_t sequence,
+                          const int* values, const uint8_t* mask, int count);
+
+// Decodes one COBS-encoded frame (without its delimiter). Returns false on bad framing or CRC.
+bool decodeSliderPacket(const uint8_t* frame, size_t length, SliderPacket& packet);
+
+// CRC16-CCITT; pass the previous result as crc to continue over more data
+uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out);  // Returns 0 on malformed input
+
+#endif
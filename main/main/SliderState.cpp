@@ -0,0 +1,173 @@
+#include "SliderState.h"
+#include "SliderProtocol.h"
+#include "DeejTrace.h"
+#include "SerialTx.h"
+#include <string.h>
+
+const uint8_t STATE_MAGIC[4] = {'D', 'J', 'S', 'T'};
+const uint8_t STATE_FLAG_MUTED = 0x01;
+const size_t STATE_HEADER_SIZE = 16;
+const size_t STATE_RECORD_SIZE = 3;
+
+// Slot holding the newest good state, -1 if none
+int currentStateSlot = -1;
+uint32_t currentGeneration = 0;
+
+struct StateHeader {
+    int count;
+    uint32_t generation;
+    uint32_t layout;
+};
+
+static uint32_t fnv1a(uint32_t hash, uint8_t byte) {
+    return (hash ^ byte) * 16777619u;
+}
+
+uint32_t sliderLayoutId(const char* const* names, int count) {
+    uint32_t hash = fnv1a(fnv1a(2166136261u, count & 0xFF), count >> 8);
+    for (int i = 0; i < count; i++) {
+        for (const char* c = names[i]; *c; c++) hash = fnv1a(hash, *c);
+        hash = fnv1a(hash, 0);  // Keeps "ab","c" apart from "a","bc"
+    }
+    return hash;
+}
+
+static uint32_t readLe32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static bool parseStateHeader(const uint8_t* header, StateHeader& parsed) {
+    if (memcmp(header, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0 || header[4] != STATE_VERSION) {
+        return false;
+    }
+    parsed.count = header[6] | (header[7] << 8);
+    parsed.generation = readLe32(header + 8);
+    parsed.layout = readLe32(header + 12);
+    return true;
+}
+
+// Reads just the header, to rank the slots without reading them in full
+static bool readSlotHeader(int slot, uint32_t layout, StateHeader& parsed) {
+    if (!halFs().exists(STATE_SLOT_PATHS[slot])) {
+        return false;
+    }
+    HalFile file = halFs().open(STATE_SLOT_PATHS[slot], "r");
+    if (!file) {
+        return false;
+    }
+
+    uint8_t header[STATE_HEADER_SIZE];
+    bool ok = file.read(header, sizeof(header)) == sizeof(header)
+        && parseStateHeader(header, parsed)
+        && parsed.layout == layout
+        && file.size() == STATE_HEADER_SIZE + parsed.count * STATE_RECORD_SIZE + 2;
+    file.close();
+    return ok;
+}
+
+// Checks the slot's CRC, then fills the arrays from it
+static bool loadSlot(int slot, int* values, bool* muted, int* previousValues, int count) {
+    HalFile file = halFs().open(STATE_SLOT_PATHS[slot], "r");
+    if (!file) {
+        return false;
+    }
+
+    uint8_t header[STATE_HEADER_SIZE];
+    StateHeader parsed;
+    if (file.read(header, sizeof(header)) != sizeof(header) || !parseStateHeader(header, parsed)) {
+        file.close();
+        return false;
+    }
+
+    uint16_t crc = crc16(header, sizeof(header));
+    uint8_t record[STATE_RECORD_SIZE];
+    for (int i = 0; i < parsed.count; i++) {
+        if (file.read(record, sizeof(record)) != sizeof(record)) {
+            file.close();
+            return false;
+        }
+        crc = crc16(record, sizeof(record), crc);
+    }
+    uint8_t trailer[2];
+    if (file.read(trailer, sizeof(trailer)) != sizeof(trailer) || crc != (trailer[0] | (trailer[1] << 8))) {
+        file.close();
+        return false;
+    }
+
+    file.seek(sizeof(header));
+    for (int i = 0; i < parsed.count && i < count; i++) {
+        file.read(record, sizeof(record));
+        values[i] = record[0];
+        previousValues[i] = record[1];
+        muted[i] = record[2] & STATE_FLAG_MUTED;
+    }
+    file.close();
+
+    currentStateSlot = slot;
+    currentGeneration = parsed.generation;
+    return true;
+}
+
+bool loadSliderState(int* values, bool* muted, int* previousValues, int count, uint32_t layout) {
+    StateHeader headers[2];
+    bool present[2] = {readSlotHeader(0, layout, headers[0]), readSlotHeader(1, layout, headers[1])};
+
+    // Try the newer slot first, then fall back to the other
+    int first = 0;
+    if (present[0] && present[1]) {
+        first = (int32_t)(headers[1].generation - headers[0].generation) > 0 ? 1 : 0;
+    } else if (present[1]) {
+        first = 1;
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int slot = attempt == 0 ? first : 1 - first;
+        if (present[slot] && loadSlot(slot, values, muted, previousValues, count)) {
+            if (attempt > 0) {
+                serialLog("Newest slider state was damaged, using the previous one.");
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool saveSliderState(const int* values, const bool* muted, const int* previousValues, int count, uint32_t layout) {
+    int slot = currentStateSlot == 0 ? 1 : 0;
+    uint32_t generation = currentGeneration + 1;
+
+    HalFile file = halFs().open(STATE_SLOT_PATHS[slot], "w");
+    if (!file) {
+        serialLog("Failed to open slider state for writing");
+        return false;
+    }
+
+    uint8_t header[STATE_HEADER_SIZE] = {
+        STATE_MAGIC[0], STATE_MAGIC[1], STATE_MAGIC[2], STATE_MAGIC[3],
+        STATE_VERSION, 0, (uint8_t)(count & 0xFF), (uint8_t)(count >> 8),
+        (uint8_t)generation, (uint8_t)(generation >> 8), (uint8_t)(generation >> 16), (uint8_t)(generation >> 24),
+        (uint8_t)layout, (uint8_t)(layout >> 8), (uint8_t)(layout >> 16), (uint8_t)(layout >> 24)
+    };
+    size_t written = file.write(header, sizeof(header));
+    uint16_t crc = crc16(header, sizeof(header));
+
+    for (int i = 0; i < count; i++) {
+        uint8_t record[STATE_RECORD_SIZE] = {(uint8_t)values[i], (uint8_t)previousValues[i],
+                                             (uint8_t)(muted[i] ? STATE_FLAG_MUTED : 0)};
+        written += file.write(record, sizeof(record));
+        crc = crc16(record, sizeof(record), crc);
+    }
+
+    uint8_t trailer[2] = {(uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8)};
+    written += file.write(trailer, sizeof(trailer));
+    file.close();
+    DEEJ_TRACE_FS_WRITE(STATE_SLOT_PATHS[slot], written);
+
+    if (written != sizeof(header) + count * STATE_RECORD_SIZE + sizeof(trailer)) {
+        return false;
+    }
+
+    currentStateSlot = slot;
+    currentGeneration = generation;
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef SLIDERSTATE_H
+#define SLIDERSTATE_H
+
+#include "Hal.h"
+
+// Runtime slider state (value, mute, previous value), kept apart from the
+// human-edited JSON config in two small fixed-layout binary slots:
+//
+//   magic "DJST", version, reserved byte, slider count (2 bytes LE),
+//   generation (4 bytes LE), layout (4 bytes LE)
+//   per slider: value, previous value, flags
+//   CRC16 of everything above (2 bytes LE)
+//
+// The layout is sliderLayoutId() of the config the state was saved for.
+// State saved for another layout is ignored, since its slider indices mean
+// other sliders; a config reload rewrites the state for the new layout, but
+// a reboot can come first.
+//
+// Saves alternate between the slots with an increasing generation, so the
+// slot being written is never the one holding the newest good state. A write
+// cut short by power loss fails its CRC and boot falls back to the other slot.
+//
+// The journal (SliderJournal.h) records changes since the newest snapshot.
+
+const char* const STATE_SLOT_PATHS[2] = {"/sliders_state.a", "/sliders_state.b"};
+const uint8_t STATE_VERSION = 3;
+
+// Identifies the slider count and names, in order (FNV-1a)
+uint32_t sliderLayoutId(const char* const* names, int count);
+
+bool saveSliderState(const int* values, const bool* muted, const int* previousValues, int count, uint32_t layout);
+
+// Fills the arrays from the newest valid slot saved for this layout. Returns
+// false if there is none.
+bool loadSliderState(int* values, bool* muted, int* previousValues, int count, uint32_t layout);
+
+#endif
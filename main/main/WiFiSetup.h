@@ -6,15 +6,24 @@
 #include <ESPmDNS.h>
 #include <DNSServer.h>
 #include <WebServer.h>
-#include <SPIFFS.h>
 #include <ArduinoJson.h>
-#include <U8g2lib.h>
+#include "Hal.h"
 
 extern bool wifiSetupDone;
 extern bool useWifi;
 extern bool inWifiSetupMode; // Declare that we're using AP mode and stopping Deej control
-extern U8G2_SH1106_128X64_NONAME_F_HW_I2C u8g2;
 extern const bool useTxPowerControl;
+extern unsigned long serialFramesSent;
+extern unsigned long serialFramesSuppressed;
+extern unsigned long serialTxBytesWritten;
+extern unsigned long serialTxFramesDropped;
+extern unsigned long serialTxBlockedMicros;
+extern volatile uint32_t inputQueueOverflows;
+extern unsigned long persistenceWrites;
+extern unsigned long persistenceCoalesced;
+extern unsigned long persistenceFailures;
+extern unsigned long persistenceLastWriteMicros;
+extern unsigned long persistenceMaxWriteMicros;
 
 void initWiFiSetup();
 void handleWiFiTasks();
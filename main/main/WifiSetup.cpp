@@ -1,4 +1,9 @@
 #include "WiFiSetup.h"
+#include "LoopProfiler.h"
+#include "DisplayRenderer.h"
+#include "DeejControl.h"
+#include "SliderConfig.h"
+#include "SerialTx.h"
 
 const char* apSSID = "DEEJ";
 DNSServer dnsServer;
@@ -8,6 +13,32 @@ bool wifiSetupDone = false;
 bool useWifi = true;
 bool inWifiSetupMode = false; // Initially false
 
+// Station connection, advanced from handleWiFiTasks() so the control loop never waits on it
+enum WifiConnectState {
+    WIFI_IDLE,        // Off, given up, or serving the access point
+    WIFI_CONNECTING,
+    WIFI_CONNECTED
+};
+const int CONNECT_ATTEMPTS = 5;
+const unsigned long CONNECT_ATTEMPT_MS = 5000;
+const unsigned long STATUS_SHOW_MS = 5000;
+const unsigned long AP_LINGER_MS = 3000;  // Keeps the access point up for the upload's reply page
+
+WifiConnectState wifiState = WIFI_IDLE;
+int connectAttempt = 0;
+unsigned long attemptStartTime = 0;
+unsigned long statusClearTime = 0;  // When a temporary status line goes away, 0 if none
+bool webServerStarted = false;
+bool dnsServerStarted = false;
+bool apStarted = false;
+unsigned long apStopTime = 0;  // When to leave the setup access point after an upload, 0 if not
+
+// Credentials from the connect page, saved once they have joined the network
+bool credentialsPending = false;
+String pendingSsid, pendingPassword;
+String connectResult = "";  // Shown on the root page after a failed attempt
+unsigned long restartTime = 0;  // When to reboot onto the new network, 0 if not
+
 // Forward declarations
 void handleRoot();
 void handleScan();
@@ -19,15 +50,42 @@ void handleFileUpload();
 void handleWiFiSettingsPage();
 void handleEnableWiFi();
 void handleDisableWiFi();
+void handleStats();
+void startStationConnection(const String& ssid, const String& password);
+#ifdef DEEJ_PROFILE
+void handleProfile();
+
+// Collects HAL print output for a response body
+class StringPrint : public HalPrint {
+public:
+    using HalPrint::write;
+    size_t write(const uint8_t* data, size_t length) override {
+        text.reserve(text.length() + length);
+        for (size_t i = 0; i < length; i++) text += (char)data[i];
+        return length;
+    }
+    String text;
+};
+#endif
 
 void displayMessage(String line1, String line2, String line3) {
-    u8g2.clearBuffer();
-    u8g2.setFont(u8g2_font_ncenB08_tr);
-    u8g2.drawStr(0, 15, line1.c_str());
-    u8g2.drawStr(0, 35, line2.c_str());
-    u8g2.drawStr(0, 55, line3.c_str());
-    u8g2.sendBuffer();
-    Serial.println(line1 + " | " + line2 + " | " + line3);
+    lockDisplay();
+    halDisplay().clearBuffer();
+    halDisplay().setFont(HAL_FONT_NORMAL);
+    halDisplay().drawStr(0, 15, line1.c_str());
+    halDisplay().drawStr(0, 35, line2.c_str());
+    halDisplay().drawStr(0, 55, line3.c_str());
+    halDisplay().sendBuffer();
+    invalidateDisplay();
+    unlockDisplay();
+    serialLog("%s | %s | %s", line1.c_str(), line2.c_str(), line3.c_str());
+}
+
+// Status line under the slider name, for showMs or until replaced if 0
+void showWifiStatus(const String& text, unsigned long showMs) {
+    setDisplayStatus(text.c_str());
+    serialLog("%s", text.c_str());
+    statusClearTime = showMs ? (halMillis() + showMs) | 1 : 0;
 }
 
 // Save WiFi credentials to SPIFFS (including useWifi)
@@ -37,13 +95,13 @@ void saveWiFiCredentials(const char* ssid, const char* password) {
     jsonDoc["password"] = password;
     jsonDoc["useWifi"] = useWifi;
 
-    File file = SPIFFS.open("/wifi_config.json", "w");
+    HalFile file = halFs().open("/wifi_config.json", "w");
     if (file) {
         serializeJson(jsonDoc, file);
         file.close();
-        Serial.println("WiFi credentials saved.");
+        serialLog("WiFi credentials saved.");
     } else {
-        Serial.println("Failed to save WiFi credentials.");
+        serialLog("Failed to save WiFi credentials.");
     }
 }
 
@@ -58,21 +116,21 @@ void saveWiFiSetting(bool enabled) {
     jsonDoc["password"] = password;
     jsonDoc["useWifi"] = useWifi;
 
-    File file = SPIFFS.open("/wifi_config.json", "w");
+    HalFile file = halFs().open("/wifi_config.json", "w");
     if (file) {
         serializeJson(jsonDoc, file);
         file.close();
-        Serial.printf("WiFi setting changed to %s.\n", useWifi ? "enabled" : "disabled");
+        serialLog("WiFi setting changed to %s.", useWifi ? "enabled" : "disabled");
     } else {
-        Serial.println("Failed to save WiFi setting.");
+        serialLog("Failed to save WiFi setting.");
     }
 }
 
 // Load WiFi credentials from SPIFFS
 bool loadWiFiCredentials(String &ssid, String &password) {
-    if (!SPIFFS.exists("/wifi_config.json")) return false;
+    if (!halFs().exists("/wifi_config.json")) return false;
 
-    File file = SPIFFS.open("/wifi_config.json", "r");
+    HalFile file = halFs().open("/wifi_config.json", "r");
     StaticJsonDocument<256> jsonDoc;
     if (deserializeJson(jsonDoc, file) == DeserializationError::Ok) {
         ssid = jsonDoc["ssid"] | "";
@@ -86,6 +144,11 @@ bool loadWiFiCredentials(String &ssid, String &password) {
 }
 
 void startWebServer() {
+    if (webServerStarted) {
+        return;
+    }
+    webServerStarted = true;
+
     server.on("/", HTTP_GET, handleRoot);
     server.on("/scan", HTTP_GET, handleScan);
     server.on("/connect", HTTP_GET, handleConnectPrompt);
@@ -98,8 +161,14 @@ void startWebServer() {
     server.on("/enable_wifi", HTTP_POST, handleEnableWiFi);
     server.on("/disable_wifi", HTTP_POST, handleDisableWiFi);
 
+    // Plain-text runtime statistics
+    server.on("/stats", HTTP_GET, handleStats);
+#ifdef DEEJ_PROFILE
+    server.on("/profile", HTTP_GET, handleProfile);
+#endif
+
     server.begin();
-    Serial.println("Web server started");
+    serialLog("Web server started");
 }
 
 void startAccessPoint() {
@@ -107,36 +176,43 @@ void startAccessPoint() {
     // Apply TX power control if enabled
     if (useTxPowerControl) {
         WiFi.setTxPower(WIFI_POWER_8_5dBm);
-        Serial.println("TX power control applied: 8.5 dBm");
+        serialLog("TX power control applied: 8.5 dBm");
     } else {
-        Serial.println("TX power control disabled.");
+        serialLog("TX power control disabled.");
     }
     dnsServer.start(53, "", WiFi.softAPIP());
+    dnsServerStarted = true;
+    apStarted = true;
 
     startWebServer();
-    Serial.println("AP Mode Started");
-    delay(1000);
-    displayMessage("To configure Device", "connect to DEEJ", "and visit 192.168.4.1");
+    serialLog("AP Mode Started");
+    // The sliders keep working, so this shares the screen with them
+    showWifiStatus("Setup: join DEEJ, 192.168.4.1", 0);
 }
 
 // startWifiSetupMode: enters AP mode without altering useWifi setting.
 // Also sets inWifiSetupMode = true to stop DeejControl loops.
 void startWifiSetupMode() {
     inWifiSetupMode = true;
+    wifiState = WIFI_IDLE;
+    apStopTime = 0;
+    credentialsPending = false;
     WiFi.mode(WIFI_AP);
     WiFi.softAP(apSSID);
     // Apply TX power control if enabled
     if (useTxPowerControl) {
         WiFi.setTxPower(WIFI_POWER_8_5dBm);
-        Serial.println("TX power control applied: 8.5 dBm");
+        serialLog("TX power control applied: 8.5 dBm");
     } else {
-        Serial.println("TX power control disabled.");
+        serialLog("TX power control disabled.");
     }
     dnsServer.start(53, "", WiFi.softAPIP());
-    startWebServer(); 
-    Serial.println("AP Mode Started");
+    dnsServerStarted = true;
+    apStarted = true;
+    startWebServer();
+    serialLog("AP Mode Started");
 
-    delay(1000);
+    halDelay(1000);
     displayMessage("To configure device", "connect to DEEJ", "and visit 192.168.4.1");
 }
 
@@ -172,6 +248,9 @@ String htmlFooter() {
 void handleRoot() {
     String html = htmlHeader("WiFi Setup");
     html += "<h1>WiFi Setup</h1>";
+    if (connectResult != "") {
+        html += "<p>" + connectResult + "</p>";
+    }
     html += "<div class='nav'><a href='/scan'>Scan Networks</a> | <a href='/config'>Upload Slider Config</a> | <a href='/wifi_settings'>WiFi Settings</a></div>";
     if (scannedNetworks != "") {
         html += "<h3>Available Networks</h3><ul>" + scannedNetworks + "</ul>";
@@ -186,20 +265,20 @@ void handleRoot() {
 void handleScan() {
     scannedNetworks = "";
 
-    Serial.println("Starting WiFi scan...");
+    serialLog("Starting WiFi scan...");
     int n = WiFi.scanNetworks();
 
     if (n > 0) {
-        Serial.println("Networks found: " + String(n));
+        serialLog("Networks found: %d", n);
         for (int i = 0; i < n; i++) {
             scannedNetworks += "<li><a href='/connect?ssid=" + WiFi.SSID(i) + "'>" + WiFi.SSID(i) + "</a></li>";
         }
     } else if (n == 0) {
         scannedNetworks = "<li>No networks found</li>";
-        Serial.println("No networks found.");
+        serialLog("No networks found.");
     } else {
         scannedNetworks = "<li>WiFi scan failed</li>";
-        Serial.println("WiFi scan failed.");
+        serialLog("WiFi scan failed.");
     }
 
     handleRoot();
@@ -226,38 +305,18 @@ void handleConnectPrompt() {
 // Handle WiFi connection
 void handleConnect() {
     if (server.hasArg("ssid") && server.hasArg("password")) {
-        String ssid = server.arg("ssid");
-        String password = server.arg("password");
-        WiFi.begin(ssid.c_str(), password.c_str());
-        // Apply TX power control if enabled
-        if (useTxPowerControl) {
-            WiFi.setTxPower(WIFI_POWER_8_5dBm);
-            Serial.println("TX power control applied: 8.5 dBm");
-        } else {
-            Serial.println("TX power control disabled.");
-        }
-        for (int attempts = 0; attempts < 5; attempts++) {
-            if (WiFi.status() == WL_CONNECTED) {
-                saveWiFiCredentials(ssid.c_str(), password.c_str());
-                saveWiFiSetting(true);
-                String html = htmlHeader("Connected");
-                html += "<h1>Connected!</h1><p>Rebooting...</p>";
-                html += htmlFooter();
-                server.send(200, "text/html", html);
-                displayMessage("Connected!", "Rebooting...", "");
-                delay(2000);
-                ESP.restart();
-                return;
-            }
-            displayMessage("Connecting to", ssid, "Attempt: " + String(attempts + 1));
-            delay(5000);
-        }
-
-        String html = htmlHeader("Connection Failed");
-        html += "<h1>Connection Failed</h1><p>Check your credentials and try again.</p><p><a href='/'>Back</a></p>";
+        // Joined from updateWiFiConnection(), so the loop keeps running meanwhile
+        pendingSsid = server.arg("ssid");
+        pendingPassword = server.arg("password");
+        credentialsPending = true;
+        connectResult = "";
+        startStationConnection(pendingSsid, pendingPassword);
+
+        String html = htmlHeader("Connecting");
+        html += "<h1>Connecting to " + pendingSsid + "</h1>";
+        html += "<p>The device reboots once it has joined. If it fails, the display says so; <a href='/'>check here</a> and try again.</p>";
         html += htmlFooter();
-        server.send(400, "text/html", html);
-        displayMessage("Failed", "Check Credentials", "");
+        server.send(200, "text/html", html);
     }
 }
 
@@ -274,40 +333,80 @@ void handleConfigPage() {
     server.send(200, "text/html", html);
 }
 
-// Handle file upload
+// Why the current upload was rejected, empty once it is installed
+const char* const NO_UPLOAD = "No file uploaded";
+String uploadError = NO_UPLOAD;
+
+// Handle file upload. The upload goes to a temporary file and only replaces
+// the live config once it has been checked, so a bad or cut-off upload leaves
+// the working config alone.
 void handleFileUpload() {
     HTTPUpload& upload = server.upload();
-    static File uploadFile;
+    static HalFile uploadFile;
 
     if (upload.status == UPLOAD_FILE_START) {
-        Serial.printf("Upload Start: %s\n", upload.filename.c_str());
-        if (SPIFFS.exists("/sliders_config.json")) {
-            SPIFFS.remove("/sliders_config.json");
+        serialLog("Upload Start: %s", upload.filename.c_str());
+        uploadError = "";
+        uploadFile = halFs().open(SLIDER_CONFIG_UPLOAD_PATH, "w");
+        if (!uploadFile) {
+            uploadError = "Could not create the upload file";
         }
-        uploadFile = SPIFFS.open("/sliders_config.json", "w");
     } else if (upload.status == UPLOAD_FILE_WRITE) {
-        if (uploadFile) {
-            uploadFile.write(upload.buf, upload.currentSize);
+        if (uploadFile && uploadFile.write(upload.buf, upload.currentSize) != upload.currentSize) {
+            uploadError = "Not enough space for the config";
+            uploadFile.close();
         }
     } else if (upload.status == UPLOAD_FILE_END) {
-        if (uploadFile) {
-            uploadFile.close();
-            Serial.printf("Upload End: %s (%u bytes)\n", upload.filename.c_str(), upload.totalSize);
-        } else {
-            Serial.println("Upload failed - could not open file");
+        if (!uploadFile) {
+            halFs().remove(SLIDER_CONFIG_UPLOAD_PATH);
+            return;
+        }
+        uploadFile.close();
+        serialLog("Upload End: %s (%u bytes)", upload.filename.c_str(), (unsigned)upload.totalSize);
+
+        HalFile file = halFs().open(SLIDER_CONFIG_UPLOAD_PATH, "r");
+        const char* error = file ? checkSliderConfig(file) : "Could not read the upload file";
+        file.close();
+
+        if (error) {
+            uploadError = error;
+        } else if (!replaceSliderConfig(SLIDER_CONFIG_UPLOAD_PATH)) {
+            uploadError = "Could not replace the config";
         }
+        halFs().remove(SLIDER_CONFIG_UPLOAD_PATH);
+    } else if (upload.status == UPLOAD_FILE_ABORTED) {
+        uploadError = "Upload aborted";
+        uploadFile.close();
+        halFs().remove(SLIDER_CONFIG_UPLOAD_PATH);
     }
 }
 
 // After file upload post
 void handleFileUploadPost() {
+    String error = uploadError;
+    uploadError = NO_UPLOAD;
+    if (error.length() > 0) {
+        serialLog("Config upload rejected: %s", error.c_str());
+        String message = htmlHeader("Configuration Rejected");
+        message += "<h1>Configuration Rejected</h1><p>" + error + "</p>";
+        message += "<p>The current configuration was kept.</p><p><a href='/config'>Back</a></p>";
+        message += htmlFooter();
+        server.send(400, "text/html", message);
+        return;
+    }
+
+    // Applied by the control loop on its next pass, so leave setup mode for it to run.
+    // The browser is on the access point, so it stays up until the reply is out.
+    requestConfigReload();
+    if (inWifiSetupMode) {
+        inWifiSetupMode = false;
+        apStopTime = (halMillis() + AP_LINGER_MS) | 1;
+    }
+
     String message = htmlHeader("Configuration Uploaded");
-    message += "<h1>Configuration Uploaded</h1><p>Device will reboot in a few seconds.</p>";
+    message += "<h1>Configuration Uploaded</h1><p>The new sliders are active.</p><p><a href='/config'>Back</a></p>";
     message += htmlFooter();
     server.send(200, "text/html", message);
-
-    delay(3000);
-    ESP.restart();
 }
 
 // WiFi Settings page
@@ -335,8 +434,8 @@ void handleEnableWiFi() {
         html += "<h1>Enabling WiFi...</h1><p>Rebooting in a moment.</p>";
         html += htmlFooter();
         server.send(200, "text/html", html);
-        delay(2000);
-        ESP.restart();
+        halDelay(2000);
+        halRestart();
     }
 }
 
@@ -353,58 +452,194 @@ void handleDisableWiFi() {
         html += "<h1>Disabling WiFi...</h1><p>Rebooting in a moment.</p>";
         html += htmlFooter();
         server.send(200, "text/html", html);
-        delay(2000);
-        ESP.restart();
+        halDelay(2000);
+        halRestart();
+    }
+}
+
+// Runtime statistics as plain text
+void handleStats() {
+    String text = "serial_frames_sent " + String(serialFramesSent) + "\n";
+    text += "serial_frames_suppressed " + String(serialFramesSuppressed) + "\n";
+    text += "serial_tx_bytes_written " + String(serialTxBytesWritten) + "\n";
+    text += "serial_tx_frames_dropped " + String(serialTxFramesDropped) + "\n";
+    text += "serial_tx_blocked_us " + String(serialTxBlockedMicros) + "\n";
+    text += "serial_log_dropped " + String(serialLogDropped) + "\n";
+    text += "display_frames_rendered " + String(displayFramesRendered) + "\n";
+    text += "display_bytes_sent " + String(displayBytesSent) + "\n";
+    text += "persistence_writes " + String(persistenceWrites) + "\n";
+    text += "persistence_coalesced " + String(persistenceCoalesced) + "\n";
+    text += "persistence_failures " + String(persistenceFailures) + "\n";
+    text += "persistence_last_write_us " + String(persistenceLastWriteMicros) + "\n";
+    text += "persistence_max_write_us " + String(persistenceMaxWriteMicros) + "\n";
+    text += "input_queue_overflows " + String((unsigned long)inputQueueOverflows) + "\n";
+    server.send(200, "text/plain", text);
+}
+
+#ifdef DEEJ_PROFILE
+// Loop phase timings, reset with /profile?reset
+void handleProfile() {
+    StringPrint report;
+    printProfileReport(report);
+    if (server.hasArg("reset")) {
+        resetProfile();
+    }
+    server.send(200, "text/plain", report.text);
+}
+#endif
+
+void showConnectProgress() {
+    if (credentialsPending) {
+        displayMessage("Connecting to", pendingSsid, "Attempt: " + String(connectAttempt));
+    } else {
+        showWifiStatus("WiFi: connecting " + String(connectAttempt) + "/" + String(CONNECT_ATTEMPTS), 0);
+    }
+}
+
+// Starts joining a network; updateWiFiConnection() follows it from the loop
+void startStationConnection(const String& ssid, const String& password) {
+    // Keeps a running access point up, as the browser that sent the credentials is on it
+    WiFi.mode(apStarted ? WIFI_AP_STA : WIFI_STA);
+    WiFi.begin(ssid.c_str(), password.c_str());
+    // Apply TX power control if enabled
+    if (useTxPowerControl) {
+        WiFi.setTxPower(WIFI_POWER_8_5dBm);
+        serialLog("TX power control applied: 8.5 dBm");
+    } else {
+        serialLog("TX power control disabled.");
     }
+    serialLog("Connecting to %s", ssid.c_str());
+    wifiState = WIFI_CONNECTING;
+    connectAttempt = 1;
+    attemptStartTime = halMillis();
+    showConnectProgress();
 }
 
+// Starts connecting, or the access point if there are no credentials. Returns
+// at once; handleWiFiTasks() follows the connection from the loop.
 void initWiFiSetup() {
     String ssid, password;
     bool credsLoaded = loadWiFiCredentials(ssid, password);
 
+    if (inWifiSetupMode) {
+        // The control loop could not start and already opened the access point
+        return;
+    }
+
     if (!useWifi) {
-        Serial.println("WiFi usage disabled. Skipping WiFi setup.");
+        serialLog("WiFi usage disabled. Skipping WiFi setup.");
         wifiSetupDone = true;
         return;
     }
 
     if (credsLoaded && ssid.length() > 0) {
-        WiFi.mode(WIFI_STA);
-        WiFi.begin(ssid.c_str(), password.c_str());
-        // Apply TX power control if enabled
-        if (useTxPowerControl) {
-            WiFi.setTxPower(WIFI_POWER_8_5dBm);
-            Serial.println("TX power control applied: 8.5 dBm");
-        } else {
-            Serial.println("TX power control disabled.");
-        }
-        int attemptCount = 0;
-        while (attemptCount < 5) {
-            if (WiFi.status() == WL_CONNECTED) {
-                wifiSetupDone = true;
-                displayMessage("Connected", WiFi.localIP().toString(), "");
-                Serial.println("WiFi Connected Successfully.");
-                startWebServer();
-                delay(5000);
-                return;
-            }
-
-            displayMessage("Connecting to", ssid, "Attempt: " + String(attemptCount + 1));
-            delay(5000);
-            attemptCount++;
-        }
-
-        Serial.println("WiFi connection failed after 5 attempts.");
-        displayMessage("WiFi Failed", "Stopping WiFi...", "");
-        WiFi.disconnect();
-        WiFi.mode(WIFI_OFF);
-        delay(2000);
+        startStationConnection(ssid, password);
     } else {
         startAccessPoint();
     }
 }
 
+// Leaves the setup access point once a config upload has ended setup mode,
+// for what boot would have set up with the saved WiFi settings
+void stopSetupAccessPoint() {
+    apStopTime = 0;
+    String ssid, password;
+    bool credsLoaded = loadWiFiCredentials(ssid, password) && ssid.length() > 0;
+    if (useWifi && !credsLoaded) {
+        // Nothing to join, so the access point stays, as at boot without credentials
+        showWifiStatus("Setup: join DEEJ, 192.168.4.1", 0);
+        return;
+    }
+
+    dnsServer.stop();
+    dnsServerStarted = false;
+    WiFi.softAPdisconnect(true);
+    apStarted = false;
+    serialLog("AP Mode Stopped");
+
+    if (useWifi) {
+        startStationConnection(ssid, password);
+    } else {
+        WiFi.mode(WIFI_OFF);
+    }
+}
+
+void updateWiFiConnection() {
+    unsigned long now = halMillis();
+    if (statusClearTime && (long)(now - statusClearTime) >= 0) {
+        setDisplayStatus("");
+        statusClearTime = 0;
+    }
+    if (apStopTime && (long)(now - apStopTime) >= 0) {
+        stopSetupAccessPoint();
+    }
+    if (restartTime && (long)(now - restartTime) >= 0) {
+        halRestart();
+    }
+
+    if (wifiState != WIFI_CONNECTING) {
+        return;
+    }
+
+    if (WiFi.status() == WL_CONNECTED && credentialsPending) {
+        // Reboots so the device comes up on the network it has just joined
+        wifiState = WIFI_CONNECTED;
+        credentialsPending = false;
+        saveWiFiCredentials(pendingSsid.c_str(), pendingPassword.c_str());
+        saveWiFiSetting(true);
+        displayMessage("Connected!", "Rebooting...", "");
+        restartTime = (now + 2000) | 1;
+        return;
+    }
+
+    if (WiFi.status() == WL_CONNECTED) {
+        wifiState = WIFI_CONNECTED;
+        wifiSetupDone = true;
+        serialLog("WiFi Connected Successfully.");
+        showWifiStatus("WiFi: " + WiFi.localIP().toString(), STATUS_SHOW_MS);
+        startWebServer();
+        return;
+    }
+
+    if (now - attemptStartTime < CONNECT_ATTEMPT_MS) {
+        return;
+    }
+
+    if (connectAttempt < CONNECT_ATTEMPTS) {
+        connectAttempt++;
+        attemptStartTime = now;
+        showConnectProgress();
+        return;
+    }
+
+    if (credentialsPending) {
+        // The access point stays, so the user can try other credentials
+        serialLog("WiFi connection to %s failed.", pendingSsid.c_str());
+        credentialsPending = false;
+        WiFi.disconnect();
+        if (apStarted) {
+            WiFi.mode(WIFI_AP);
+        }
+        wifiState = WIFI_IDLE;
+        connectResult = "Connection to " + pendingSsid + " failed. Check your credentials and try again.";
+        displayMessage("Failed", "Check Credentials", "");
+        return;
+    }
+
+    serialLog("WiFi connection failed after %d attempts.", CONNECT_ATTEMPTS);
+    WiFi.disconnect();
+    WiFi.mode(WIFI_OFF);
+    wifiState = WIFI_IDLE;
+    wifiSetupDone = true;
+    showWifiStatus("WiFi: failed, stopped", STATUS_SHOW_MS);
+}
+
 void handleWiFiTasks() {
-    dnsServer.processNextRequest();
-    server.handleClient();
+    updateWiFiConnection();
+    if (dnsServerStarted) {
+        dnsServer.processNextRequest();
+    }
+    if (webServerStarted) {
+        server.handleClient();
+    }
 }
@@ -3,6 +3,8 @@
 #include <U8g2lib.h>
 #include "WiFiSetup.h" // Handles WiFi-related functionality
 #include "DeejControl.h" // Handles Deej slider control
+#include "DisplayRenderer.h"
+#include "SerialTx.h"
 
 // Pin definitions
 const int ENCODER1_CLK = 4; // Define CLK pin for encoder 1
@@ -13,62 +15,73 @@ const int ENCODER2_CLK = 3; // Define CLK pin for encoder 2
 const int ENCODER2_DT = 10; // Define DT pin for encoder 2
 const int ENCODER2_SW = 8; // Define SW pin for encoder 2
 
+// Encoder decoding: quadrature edges per detent, reversed direction, reject glitches
+const QuadratureConfig encoder1Config = {2, true, true};  // Volume
+const QuadratureConfig encoder2Config = {2, false, true}; // Slider selection
+
+// Buttons: debounce, double-click window and long-press time (ms)
+const ButtonConfig button1Config = {30, 300, 1000};  // Press toggles mute
+const ButtonConfig button2Config = {30, 300, 10000}; // Long press enters WiFi setup mode
+
+const unsigned int displayMaxFps = 30; // Upper limit on display redraws per second
+
 const int OLED_SCL = 1; // Define SCL pin for OLED
 const int OLED_SDA = 2; // Define SDA pin for OLED
 
 const bool useTxPowerControl = true; // If you're using an ESP32 C3 Supermini and experiencing WiFi connection issues, set this to true.
 
+// Serial output to deej
+const SerialOutputMode serialOutputMode = SERIAL_OUTPUT_ON_CHANGE; // SERIAL_OUTPUT_EVERY_LOOP sends a frame on every loop pass
+const unsigned long keyframeInterval = 1000; // Resend all values at least this often (ms) so deej can resync
+const SerialProtocol serialProtocol = SERIAL_PROTOCOL_ASCII; // SERIAL_PROTOCOL_BINARY needs tools/deej_bridge on the host
+
 
-Encoder encoder1(ENCODER1_CLK, ENCODER1_DT); // Encoder 1 object
-Encoder encoder2(ENCODER2_CLK, ENCODER2_DT); // Encoder 2 object
 U8G2_SH1106_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, U8X8_PIN_NONE, OLED_SCL, OLED_SDA);
 
-extern bool wifiSetupDone;
 extern bool useWifi;
 extern bool inWifiSetupMode; 
 
 void displayError(const char* line1, const char* line2) {
+    lockDisplay();
     u8g2.clearBuffer();
     u8g2.setFont(u8g2_font_ncenB08_tr);
     u8g2.drawStr(0, 15, line1);
     u8g2.drawStr(0, 35, line2);
     u8g2.sendBuffer();
+    invalidateDisplay();
+    unlockDisplay();
 }
 
 void setup() {
     Serial.begin(115200);
+    initSerialLog();
     u8g2.begin();
 
     // Initialize SPIFFS
     if (!SPIFFS.begin(true)) {
-        Serial.println("SPIFFS Mount Failed");
+        serialLog("SPIFFS Mount Failed");
         displayError("SPIFFS Error", "Restart Required");
-        while (true) { delay(1000); }
+        while (true) { serviceSerialTx(); delay(1000); }
     } else {
-        Serial.println("SPIFFS Mounted Successfully");
+        serialLog("SPIFFS Mounted Successfully");
     }
 
-    // Initialize WiFi setup
-    initWiFiSetup();
-
-    // Initialize Deej Slider Control
+    // Initialize Deej Slider Control first, so frames go out while WiFi connects
     initDeejControl();
+
+    // Start WiFi setup; the connection is followed from loop()
+    initWiFiSetup();
 }
 
 void loop() {
     // Handle WiFi setup mode
     if (inWifiSetupMode) {
         handleWiFiTasks();
+        serviceSerialTx(); // Log lines still go out
         return; // Skip DeejControl logic while in setup mode
     }
 
     // Normal operation
-    if (!wifiSetupDone && useWifi) {
-        handleWiFiTasks(); // Continue handling WiFi tasks until setup is done
-    } else if (useWifi) {
-        handleWiFiTasks(); // Run WiFi-related tasks
-        runDeejControl();  // Run Deej logic alongside
-    } else {
-        runDeejControl();  // If WiFi is disabled, only run Deej logic
-    }
+    handleWiFiTasks(); // Advances the WiFi connection, serves the web UI and closes the setup access point
+    runDeejControl();
 }
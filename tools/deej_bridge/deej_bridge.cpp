@@ -0,0 +1,166 @@
+// Host-side bridge for SERIAL_PROTOCOL_BINARY.
+//
+// Reads COBS-framed slider packets from the controller's serial port (or stdin)
+// and writes deej's "a|b|c" text lines to a pseudo-terminal, so deej can be
+// pointed at the pty instead of the real port.
+//
+// Build:
+//   g++ -O2 -I../../main/main -o deej_bridge deej_bridge.cpp
+//       ../../main/main/SliderProtocol.cpp ../../main/main/DeejFrame.cpp
+//
+// Usage:
+//   ./deej_bridge /dev/ttyACM0     (or "-" to read from stdin)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "SliderProtocol.h"
+
+// The controller's log lines come between frames, as text ending in "\r\n"
+// and delimited by 0x00 like a frame
+static bool isLogLine(const uint8_t* data, size_t length) {
+    if (length < 2 || data[length - 2] != '\r' || data[length - 1] != '\n') {
+        return false;
+    }
+    for (size_t i = 0; i < length - 2; i++) {
+        if (data[i] < 0x20 || data[i] > 0x7E) return false;
+    }
+    return true;
+}
+
+static int openInput(const char* path) {
+    if (strcmp(path, "-") == 0) {
+        return STDIN_FILENO;
+    }
+
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct termios tty;
+    if (tcgetattr(fd, &tty) == 0) {
+        cfmakeraw(&tty);
+        cfsetspeed(&tty, B115200);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+    return fd;
+}
+
+static int openPty() {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        perror("pty");
+        return -1;
+    }
+
+    struct termios tty;
+    if (tcgetattr(fd, &tty) == 0) {
+        cfmakeraw(&tty);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+
+    printf("deej port: %s\n", ptsname(fd));
+    fflush(stdout);
+    return fd;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <serial device | ->\n", argv[0]);
+        return 1;
+    }
+
+    int in = openInput(argv[1]);
+    int out = openPty();
+    if (in < 0 || out < 0) {
+        return 1;
+    }
+
+    static uint8_t frame[SLIDER_PACKET_MAX_RAW * 2];
+    size_t frameLength = 0;
+    bool overflow = false;
+
+    static SliderPacket packet;
+    uint16_t values[SLIDER_PACKET_MAX_SLIDERS] = {0};
+    int count = 0;
+    bool synced = false;  // Set once a keyframe has filled every value
+    int expectedSequence = -1;
+    unsigned long frames = 0, crcErrors = 0, drops = 0;
+
+    uint8_t buf[256];
+    for (;;) {
+        ssize_t n = read(in, buf, sizeof(buf));
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("read");
+            break;
+        }
+
+        for (ssize_t i = 0; i < n; i++) {
+            if (buf[i] != 0x00) {
+                if (frameLength < sizeof(frame)) frame[frameLength++] = buf[i];
+                else overflow = true;
+                continue;
+            }
+
+            bool valid = !overflow && frameLength > 0 && decodeSliderPacket(frame, frameLength, packet);
+            if (!valid && !overflow && isLogLine(frame, frameLength)) {
+                fprintf(stderr, "device: %.*s", (int)frameLength, (const char*)frame);
+                frameLength = 0;
+                continue;
+            }
+            frameLength = 0;
+            overflow = false;
+            if (!valid) {
+                crcErrors++;
+                fprintf(stderr, "bad frame (%lu so far)\n", crcErrors);
+                continue;
+            }
+
+            frames++;
+            if (expectedSequence >= 0 && packet.sequence != expectedSequence) {
+                drops += (uint8_t)(packet.sequence - expectedSequence);
+                fprintf(stderr, "sequence gap: expected %d, got %d (%lu dropped so far)\n",
+                        expectedSequence, packet.sequence, drops);
+            }
+            expectedSequence = (packet.sequence + 1) & 0xFF;
+
+            if (packet.count != count) {
+                count = packet.count;
+                synced = false;
+            }
+
+            int included = 0;
+            for (int s = 0; s < count; s++) {
+                if (packet.mask[s / 8] & (1 << (s % 8))) {
+                    values[s] = packet.values[s];
+                    included++;
+                }
+            }
+            if (included == count) synced = true;
+            if (!synced) continue;  // Wait for a keyframe before talking to deej
+
+            char line[SLIDER_PACKET_MAX_SLIDERS * 5 + 3];
+            size_t length = 0;
+            for (int s = 0; s < count; s++) {
+                length += snprintf(line + length, sizeof(line) - length, s < count - 1 ? "%u|" : "%u", values[s]);
+            }
+            length += snprintf(line + length, sizeof(line) - length, "\r\n");
+
+            if (write(out, line, length) < 0 && errno != EAGAIN) {
+                perror("write");
+            }
+        }
+    }
+
+    fprintf(stderr, "frames: %lu, bad: %lu, dropped: %lu\n", frames, crcErrors, drops);
+    return 0;
+}